@@ -2,7 +2,17 @@
 #include "eudaq/DataConverter.hh"
 #include "eudaq/FileWriter.hh"
 #include "eudaq/FileReader.hh"
+#include "eudaq/StdEventConverter.hh"
+#include "eudaq/TaskPool.hh"
 #include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 
 int main(int /*argc*/, const char **argv) {
   eudaq::OptionParser op("EUDAQ Command Line DataConverter", "2.0", "The Data Converter launcher of EUDAQ");
@@ -11,6 +21,17 @@ int main(int /*argc*/, const char **argv) {
   eudaq::Option<std::string> file_output(op, "o", "output", "", "string",
 					 "output file");
   eudaq::OptionFlag iprint(op, "ip", "iprint", "enable print of input Event");
+  eudaq::OptionFlag chunks(op, "c", "chunks", "read the input chunk and the ones numbered after it, several at once");
+  eudaq::Option<std::string> events(op, "e", "events", "", "first:last",
+				    "convert only the events with first <= event number < last, either may be left out");
+  eudaq::Option<uint32_t> threads(op, "t", "threads", 0, "uint32_t",
+				  "number of conversion threads, 0 for one per core");
+  eudaq::Option<uint32_t> chunk_events(op, "ce", "chunk-events", 0, "uint32_t",
+				       "start a new output file every n events");
+  eudaq::Option<uint32_t> chunk_size(op, "cs", "chunk-size", 0, "uint32_t",
+				     "start a new output file once the current one has n MB (writers reporting their size only)");
+  eudaq::Option<uint32_t> progress(op, "pi", "progress", 10, "seconds",
+				   "interval of the throughput output, 0 to switch it off");
 
   try{
     op.Parse(argv);
@@ -18,36 +39,196 @@ int main(int /*argc*/, const char **argv) {
   catch (...) {
     return op.HandleMainException();
   }
-  
+
   std::string infile_path = file_input.Value();
   if(infile_path.empty()){
     std::cout<<"option --help to get help"<<std::endl;
     return 1;
   }
-  
+
   std::string outfile_path = file_output.Value();
   std::string type_in = infile_path.substr(infile_path.find_last_of(".")+1);
   std::string type_out = outfile_path.substr(outfile_path.find_last_of(".")+1);
   bool print_ev_in = iprint.Value();
-  
+
   if(type_in=="raw")
-    type_in = "native";
+    type_in = chunks.Value() ?"nativechunk" :"native";
   if(type_out=="raw")
     type_out = "native";
-  
+
+  uint32_t ev_first = 0;
+  uint32_t ev_last = UINT32_MAX;
+  std::string ev_range = events.Value();
+  if(!ev_range.empty()){
+    size_t dm = ev_range.find(':');
+    std::string first = ev_range.substr(0, dm);
+    std::string last = dm==std::string::npos ?"" :ev_range.substr(dm+1);
+    if(!first.empty())
+      ev_first = std::stoul(first);
+    if(!last.empty())
+      ev_last = std::stoul(last);
+  }
+  uint64_t chunk_events_v = chunk_events.Value();
+  uint64_t chunk_bytes_v = uint64_t(chunk_size.Value()) << 20;
+  bool chunked = chunk_events_v || chunk_bytes_v;
+  std::chrono::seconds progress_v(progress.Value());
+
+  eudaq::TaskPool::SetDefaultNumWorkers(threads.Value());
+  // the ROOT writer takes StandardEvents as they are, so convert them here
+  // on all threads instead of in the writer; the slcio writer converts on
+  // the pool itself
+  bool convert_std = (type_out == "root");
+
   eudaq::FileReaderUP reader;
-  eudaq::FileWriterUP writer;
   reader = eudaq::Factory<eudaq::FileReader>::MakeUnique(eudaq::str2hash(type_in), infile_path);
-  if(!type_out.empty())
-    writer = eudaq::Factory<eudaq::FileWriter>::MakeUnique(eudaq::str2hash(type_out), outfile_path);
-  while(1){
-    auto ev = reader->GetNextEvent();
-    if(!ev)
-      break;
-    if(print_ev_in)
-      ev->Print(std::cout);
-    if(writer)
-      writer->WriteEvent(ev);
+  if(!reader){
+    std::cerr<<"No FileReader for input type "<<type_in<<std::endl;
+    return 1;
+  }
+
+  // events are numbered in reading order; the writing side takes them from
+  // done in that order
+  std::mutex mtx;
+  std::condition_variable cv_done;
+  std::condition_variable cv_space;
+  std::map<uint64_t, eudaq::EventSPC> done;
+  uint64_t seq_in = 0;
+  uint64_t seq_out = 0;
+  bool read_end = false;
+  std::atomic_bool read_stop(false);
+  const uint64_t max_flight = 1024;
+  std::atomic<uint64_t> n_read(0);
+
+  std::thread th_read([&](){
+      while(!read_stop){
+	auto ev = reader->GetNextEvent();
+	if(!ev)
+	  break;
+	n_read++;
+	uint32_t ev_n = ev->GetEventN();
+	if(ev_n < ev_first || ev_n >= ev_last)
+	  continue;
+	if(print_ev_in)
+	  ev->Print(std::cout);
+	std::unique_lock<std::mutex> lk(mtx);
+	cv_space.wait(lk, [&](){return seq_in - seq_out < max_flight || read_stop;});
+	if(read_stop)
+	  break;
+	uint64_t seq = seq_in++;
+	if(!convert_std){
+	  done[seq] = ev;
+	  lk.unlock();
+	  cv_done.notify_all();
+	  continue;
+	}
+	lk.unlock();
+	eudaq::TaskPool::Instance().Submit([&, ev, seq](){
+	    eudaq::StdEventSP evstd = eudaq::StandardEvent::MakeShared();
+	    bool ok = false;
+	    try{
+	      ok = eudaq::StdEventConverter::Convert(ev, evstd, nullptr);
+	    }
+	    catch(const std::exception &e){
+	      std::cerr<<"Fail to convert event "<<ev->GetEventN()<<": "<<e.what()<<std::endl;
+	    }
+	    std::lock_guard<std::mutex> lk(mtx);
+	    if(ok)
+	      done[seq] = evstd;
+	    else
+	      done[seq] = nullptr;
+	    cv_done.notify_all();
+	  });
+      }
+      std::lock_guard<std::mutex> lk(mtx);
+      read_end = true;
+      cv_done.notify_all();
+    });
+
+  eudaq::FileWriterUP writer;
+  uint32_t n_chunk = 0;
+  uint64_t n_chunk_ev = 0;
+  uint64_t n_write = 0;
+  auto t_start = std::chrono::steady_clock::now();
+  auto t_report = t_start;
+  uint64_t n_report = 0;
+  auto report = [&](std::chrono::steady_clock::time_point now){
+    double dt = std::chrono::duration<double>(now - t_report).count();
+    double dt_all = std::chrono::duration<double>(now - t_start).count();
+    std::cout<<"read "<<n_read<<" events, converted "<<n_write
+	     <<", "<<std::fixed<<std::setprecision(1)
+	     <<(dt>0 ?(n_write-n_report)/dt :0.)<<" events/s now, "
+	     <<(dt_all>0 ?n_write/dt_all :0.)<<" events/s overall"
+	     <<std::defaultfloat<<std::endl;
+    t_report = now;
+    n_report = n_write;
+  };
+
+  try{
+    std::unique_lock<std::mutex> lk(mtx);
+    while(1){
+      if(!cv_done.wait_for(lk, std::chrono::milliseconds(100),
+			   [&](){return done.count(seq_out) || (read_end && seq_out == seq_in);})){
+	auto now = std::chrono::steady_clock::now();
+	if(progress_v.count() && now - t_report >= progress_v)
+	  report(now);
+	continue;
+      }
+      auto it = done.find(seq_out);
+      if(it == done.end())
+	break;
+      eudaq::EventSPC ev = std::move(it->second);
+      done.erase(it);
+      lk.unlock();
+      if(ev && type_out.empty()){
+	n_write++;
+      }
+      else if(ev){
+	if(!writer){
+	  std::string path = outfile_path;
+	  if(chunked){
+	    std::ostringstream os;
+	    size_t dot = outfile_path.find_last_of(".");
+	    os<<outfile_path.substr(0, dot)<<"_"
+	      <<std::setw(4)<<std::setfill('0')<<n_chunk<<outfile_path.substr(dot);
+	    path = os.str();
+	    n_chunk++;
+	  }
+	  writer = eudaq::Factory<eudaq::FileWriter>::MakeUnique(eudaq::str2hash(type_out), path);
+	  if(!writer)
+	    EUDAQ_THROW("No FileWriter for output type "+type_out);
+	  n_chunk_ev = 0;
+	}
+	writer->WriteEvent(ev);
+	n_write++;
+	n_chunk_ev++;
+	if((chunk_events_v && n_chunk_ev >= chunk_events_v) ||
+	   (chunk_bytes_v && writer->FileBytes() >= chunk_bytes_v))
+	  writer.reset();
+      }
+      ev.reset();
+      auto now = std::chrono::steady_clock::now();
+      if(progress_v.count() && now - t_report >= progress_v)
+	report(now);
+      lk.lock();
+      seq_out++;
+      cv_space.notify_all();
+    }
+    lk.unlock();
+    writer.reset();
+  }
+  catch(const std::exception &e){
+    std::cerr<<"Conversion stopped: "<<e.what()<<std::endl;
+    {
+      std::lock_guard<std::mutex> lk(mtx);
+      read_stop = true;
+    }
+    cv_space.notify_all();
+    th_read.join();
+    eudaq::TaskPool::Instance().WaitIdle();
+    return 1;
   }
+  th_read.join();
+  if(progress_v.count())
+    report(std::chrono::steady_clock::now());
   return 0;
 }
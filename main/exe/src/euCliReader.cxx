@@ -1,88 +1,481 @@
 #include "eudaq/OptionParser.hh"
 #include "eudaq/FileReader.hh"
 #include "eudaq/StdEventConverter.hh"
+#include "eudaq/TaskPool.hh"
+#include "eudaq/FileDeserializer.hh"
+#include "eudaq/NativeFileIndex.hh"
+#include "eudaq/Crc32c.hh"
+#include "eudaq/Utils.hh"
 
 #include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <map>
+
+namespace{
+  // counts of one stream (description and stream number) in a range of
+  // events; two ranges are merged in file order
+  struct StreamStats {
+    uint64_t n_ev = 0;
+    uint64_t bytes = 0;
+    bool has_tg = false;
+    uint32_t tg_first = 0;
+    uint32_t tg_last = 0;
+    uint64_t tg_gaps = 0;
+    uint64_t tg_missing = 0;
+    uint64_t tg_disorder = 0;
+    bool has_ts = false;
+    uint64_t ts_first = 0;
+    uint64_t ts_last = 0;
+    uint64_t n_dts = 0;
+    uint64_t dts_min = UINT64_MAX;
+    uint64_t dts_max = 0;
+    double dts_sum = 0;
+    uint64_t ts_disorder = 0;
+
+    void AddTriggerGap(uint32_t last, uint32_t next){
+      if(next == last + 1)
+	return;
+      if(next > last){
+	tg_gaps++;
+	tg_missing += next - last - 1;
+      }
+      else
+	tg_disorder++;
+    }
+    void AddTimestampGap(uint64_t last, uint64_t next){
+      if(next < last){
+	ts_disorder++;
+	return;
+      }
+      uint64_t dts = next - last;
+      n_dts++;
+      dts_sum += dts;
+      if(dts < dts_min)
+	dts_min = dts;
+      if(dts > dts_max)
+	dts_max = dts;
+    }
+    void Add(const eudaq::EventHeader &h, uint64_t ev_bytes){
+      n_ev++;
+      bytes += ev_bytes;
+      if(h.flags & eudaq::Event::FLAG_TRIG){
+	if(has_tg)
+	  AddTriggerGap(tg_last, h.tg_n);
+	else
+	  tg_first = h.tg_n;
+	tg_last = h.tg_n;
+	has_tg = true;
+      }
+      if(h.flags & eudaq::Event::FLAG_TIME){
+	if(has_ts)
+	  AddTimestampGap(ts_last, h.ts_begin);
+	else
+	  ts_first = h.ts_begin;
+	ts_last = h.ts_begin;
+	has_ts = true;
+      }
+    }
+    void Merge(const StreamStats &o){
+      n_ev += o.n_ev;
+      bytes += o.bytes;
+      if(o.has_tg){
+	if(has_tg)
+	  AddTriggerGap(tg_last, o.tg_first);
+	else
+	  tg_first = o.tg_first;
+	tg_last = o.tg_last;
+	has_tg = true;
+      }
+      tg_gaps += o.tg_gaps;
+      tg_missing += o.tg_missing;
+      tg_disorder += o.tg_disorder;
+      if(o.has_ts){
+	if(has_ts)
+	  AddTimestampGap(ts_last, o.ts_first);
+	else
+	  ts_first = o.ts_first;
+	ts_last = o.ts_last;
+	has_ts = true;
+      }
+      n_dts += o.n_dts;
+      dts_sum += o.dts_sum;
+      dts_min = std::min(dts_min, o.dts_min);
+      dts_max = std::max(dts_max, o.dts_max);
+      ts_disorder += o.ts_disorder;
+    }
+  };
+
+  using StreamKey = std::pair<std::string, uint32_t>;
+
+  struct Stats {
+    uint64_t n_ev = 0;
+    uint64_t bytes = 0;
+    uint64_t size_hist[65] = {}; // events by bit length of their block bytes
+    std::map<StreamKey, StreamStats> streams;
+
+    // returns the block bytes of h and its sub-events
+    uint64_t AddStreams(const eudaq::EventHeader &h){
+      uint64_t ev_bytes = h.block_bytes;
+      for(auto &sub: h.sub_events)
+	ev_bytes += AddStreams(sub);
+      // a packet is counted through its sub-events
+      if(h.sub_events.empty())
+	streams[StreamKey(h.dspt, h.stm_n)].Add(h, ev_bytes);
+      return ev_bytes;
+    }
+    void Add(const eudaq::EventHeader &h){
+      uint64_t ev_bytes = AddStreams(h);
+      n_ev++;
+      bytes += ev_bytes;
+      int bits = 0;
+      while(bits < 64 && (ev_bytes >> bits))
+	bits++;
+      size_hist[bits]++;
+    }
+    void Merge(const Stats &o){
+      n_ev += o.n_ev;
+      bytes += o.bytes;
+      for(int i = 0; i < 65; i++)
+	size_hist[i] += o.size_hist[i];
+      for(auto &s: o.streams)
+	streams[s.first].Merge(s.second);
+    }
+    void Print(std::ostream &os) const {
+      os<<"Statistics of "<<n_ev<<" events, "<<bytes<<" bytes of block data\n";
+      for(auto &s: streams){
+	const StreamStats &st = s.second;
+	os<<"  stream "<<s.first.first<<" #"<<s.first.second<<": "<<st.n_ev<<" events, "
+	  <<st.bytes<<" bytes\n";
+	if(st.has_tg)
+	  os<<"    triggers "<<st.tg_first<<" to "<<st.tg_last<<", "<<st.tg_gaps<<" gaps with "
+	    <<st.tg_missing<<" missing, "<<st.tg_disorder<<" out of order\n";
+	if(st.n_dts)
+	  os<<"    timestamp delta min "<<st.dts_min<<" mean "<<st.dts_sum/st.n_dts
+	    <<" max "<<st.dts_max<<", "<<st.ts_disorder<<" out of order\n";
+      }
+      os<<"  events by block bytes:\n";
+      for(int i = 0; i < 65; i++){
+	if(!size_hist[i])
+	  continue;
+	uint64_t low = i ?(uint64_t(1) << (i-1)) :0;
+	os<<"    >= "<<std::setw(12)<<low<<" : "<<size_hist[i]<<"\n";
+      }
+    }
+  };
+
+  // a frame aligned byte range of a native file, checked by one task
+  struct VerifyPart {
+    uint64_t begin = 0;
+    uint64_t end = 0;
+    uint64_t n_ev = 0;
+    uint64_t n_bad = 0;
+    uint64_t first_bad = 0;
+    bool footer = false;
+    std::string error;
+  };
+
+  struct VerifyResult {
+    std::string path;
+    uint32_t version = 0;
+    std::deque<VerifyPart> parts;
+    std::string error;
+  };
+
+  using Range = std::pair<uint64_t, uint64_t>;
+
+  // splits a framed native file into frame aligned byte ranges of about
+  // part_bytes, at the event offsets of its footer or else by skipping from
+  // frame to frame
+  std::vector<Range> SplitFrames(const std::string &path, uint64_t part_bytes){
+    eudaq::FileDeserializer des(path, true);
+    des.HasData();
+    uint64_t first = des.Tell();
+    uint64_t size = des.FileSize();
+    std::vector<uint64_t> offsets;
+    eudaq::NativeFileIndex idx;
+    bool indexed = false;
+    try{
+      indexed = eudaq::NativeFileIndex::ReadFooter(path, idx);
+    }
+    catch(const std::exception &){
+    }
+    // a broken footer is not trusted, the frames are read all the same
+    if(indexed && !idx.m_offsets.empty() && idx.m_offsets.front() == first &&
+       idx.m_offsets.back() < size &&
+       std::is_sorted(idx.m_offsets.begin(), idx.m_offsets.end()))
+      offsets.swap(idx.m_offsets);
+    else{
+      uint64_t pos = first;
+      while(size - pos >= sizeof(uint64_t)){
+	offsets.push_back(pos);
+	uint64_t len;
+	des.read(len);
+	if(len > size - pos - sizeof(uint64_t))
+	  break;
+	des.Skip(len);
+	pos += sizeof(uint64_t) + len;
+      }
+    }
+    std::vector<Range> ranges;
+    uint64_t begin = first;
+    for(auto pos: offsets){
+      if(pos - begin < part_bytes)
+	continue;
+      ranges.push_back(Range(begin, pos));
+      begin = pos;
+    }
+    ranges.push_back(Range(begin, size));
+    return ranges;
+  }
+
+  void SplitFrames(VerifyResult &r, uint64_t part_bytes){
+    try{
+      {
+	eudaq::FileDeserializer des(r.path, true);
+	r.version = des.FormatVersion();
+      }
+      if(r.version < 2)
+	return;
+      for(auto &range: SplitFrames(r.path, part_bytes)){
+	r.parts.emplace_back();
+	r.parts.back().begin = range.first;
+	r.parts.back().end = range.second;
+      }
+    }
+    catch(const std::exception &e){
+      r.error = e.what();
+    }
+  }
+
+  // checks the checksum of every frame starting in a part
+  void VerifyFrames(const std::string &path, VerifyPart &p){
+    try{
+      eudaq::FileDeserializer des(path, true);
+      des.Seek(p.begin);
+      std::vector<uint8_t> frame;
+      uint64_t pos = des.Tell();
+      while(pos < p.end && des.ReadFrame(frame)){
+	size_t n = frame.size();
+	bool ok = n >= 4;
+	if(ok){
+	  uint32_t crc = frame[n-4] | (frame[n-3] << 8) | (frame[n-2] << 16) | (uint32_t(frame[n-1]) << 24);
+	  ok = eudaq::Crc32c(0, frame.data(), n-4) == crc;
+	}
+	uint32_t id = n >= 4 ?frame[0] | (frame[1] << 8) | (frame[2] << 16) | (uint32_t(frame[3]) << 24) :0;
+	if(!ok){
+	  if(!p.n_bad)
+	    p.first_bad = pos;
+	  p.n_bad++;
+	}
+	else if(id == eudaq::NATIVE_FOOTER_ID)
+	  p.footer = true;
+	if(id != eudaq::NATIVE_FOOTER_ID)
+	  p.n_ev++;
+	pos = des.Tell();
+      }
+    }
+    catch(const std::exception &e){
+      p.error = e.what();
+    }
+  }
+
+  // a frame aligned byte range of a framed native file, whose event
+  // headers are read and summed up by one task
+  struct StatsPart {
+    uint64_t begin = 0;
+    uint64_t end = 0;
+    Stats stats;
+    uint64_t n_read = 0;
+    std::string error;
+  };
+}
 
 int main(int /*argc*/, const char **argv) {
   eudaq::OptionParser op("EUDAQ Command Line FileReader modified for TLU", "2.1", "EUDAQ FileReader (TLU)");
-  eudaq::Option<std::string> file_input(op, "i", "input", "", "string", "input file");
+  eudaq::Option<std::string> file_input(op, "i", "input", "", "string", "input file, or comma separated files to be merged");
   eudaq::Option<uint32_t> eventl(op, "e", "event", 0, "uint32_t", "event number low");
   eudaq::Option<uint32_t> eventh(op, "E", "eventhigh", 0, "uint32_t", "event number high");
   eudaq::Option<uint32_t> triggerl(op, "tg", "trigger", 0, "uint32_t", "trigger number low");
   eudaq::Option<uint32_t> triggerh(op, "TG", "triggerhigh", 0, "uint32_t", "trigger number high");
-  eudaq::Option<uint32_t> timestampl(op, "ts", "timestamp", 0, "uint32_t", "timestamp low");
-  eudaq::Option<uint32_t> timestamph(op, "TS", "timestamphigh", 0, "uint32_t", "timestamp high");
-  eudaq::OptionFlag stat(op, "s", "statistics", "enable print of statistics");
+  eudaq::Option<uint64_t> timestampl(op, "ts", "timestamp", 0, "uint64_t", "timestamp low");
+  eudaq::Option<uint64_t> timestamph(op, "TS", "timestamphigh", 0, "uint64_t", "timestamp high");
+  eudaq::OptionFlag stat(op, "s", "statistics", "print statistics of the events in range instead of the events, reading their headers only");
   eudaq::OptionFlag stdev(op, "std", "stdevent", "enable converter of StdEvent");
+  eudaq::OptionFlag chunks(op, "c", "chunks", "read the input chunk and the ones numbered after it, several at once");
+  eudaq::OptionFlag verify(op, "vf", "verify", "check the checksums of the input files, several files and parts of a file at once");
 
   op.Parse(argv);
 
   std::string infile_path = file_input.Value();
   std::string type_in = infile_path.substr(infile_path.find_last_of(".")+1);
-  if(type_in=="raw")
-    type_in = "native";
+  if(infile_path.find(',') != std::string::npos)
+    type_in = "nativemerge";
+  else if(type_in=="raw")
+    type_in = chunks.Value() ?"nativechunk" :"native";
 
   bool stdev_v = stdev.Value();
-
+  bool stat_v = stat.Value();
 
   uint32_t eventl_v = eventl.Value();
   uint32_t eventh_v = eventh.Value();
   uint32_t triggerl_v = triggerl.Value();
   uint32_t triggerh_v = triggerh.Value();
-  uint32_t timestampl_v = timestampl.Value();
-  uint32_t timestamph_v = timestamph.Value();
+  uint64_t timestampl_v = timestampl.Value();
+  uint64_t timestamph_v = timestamph.Value();
   bool not_all_zero = eventl_v||eventh_v||triggerl_v||triggerh_v||timestampl_v||timestamph_v;
 
+  auto in_range = [&](uint32_t ev_n, uint32_t tg_n, uint64_t ts_beg, uint64_t ts_end){
+    if((eventl_v!=0 || eventh_v!=0) && !(ev_n >= eventl_v && ev_n < eventh_v))
+      return false;
+    if((triggerl_v!=0 || triggerh_v!=0) && !(tg_n >= triggerl_v && tg_n < triggerh_v))
+      return false;
+    if((timestampl_v!=0 || timestamph_v!=0) && !(ts_beg >= timestampl_v && ts_end <= timestamph_v))
+      return false;
+    return true;
+  };
+
+  if(verify.Value()){
+    // large files are checked in parts, several at once
+    const uint64_t part_bytes = 32 << 20;
+    std::deque<VerifyResult> results;
+    for(auto &path: eudaq::split(infile_path, ",", true)){
+      results.emplace_back();
+      results.back().path = path;
+    }
+    for(auto &r: results){
+      SplitFrames(r, part_bytes);
+      for(auto &p: r.parts){
+	const std::string *path = &r.path;
+	VerifyPart *pp = &p;
+	eudaq::TaskPool::Instance().Submit([path, pp](){VerifyFrames(*path, *pp);});
+      }
+    }
+    eudaq::TaskPool::Instance().WaitIdle();
+    bool failed = false;
+    for(auto &r: results){
+      uint64_t n_ev = 0;
+      uint64_t n_bad = 0;
+      uint64_t first_bad = 0;
+      bool footer = false;
+      for(auto &p: r.parts){
+	if(r.error.empty())
+	  r.error = p.error;
+	if(p.n_bad && !n_bad)
+	  first_bad = p.first_bad;
+	n_ev += p.n_ev;
+	n_bad += p.n_bad;
+	footer = footer || p.footer;
+      }
+      std::cout<<r.path<<": ";
+      if(!r.error.empty()){
+	std::cout<<"error, "<<r.error<<std::endl;
+	failed = true;
+      }
+      else if(r.version < 2)
+	std::cout<<"no checksums in this format"<<std::endl;
+      else if(n_bad){
+	std::cout<<n_bad<<" bad checksums, the first in the frame at byte "<<first_bad<<std::endl;
+	failed = true;
+      }
+      else
+	std::cout<<n_ev<<" events OK"<<(footer ?"" :", no footer")<<std::endl;
+    }
+    return failed ?1 :0;
+  }
+
   eudaq::FileReaderUP reader;
   reader = eudaq::Factory<eudaq::FileReader>::MakeUnique(eudaq::str2hash(type_in), infile_path);
   uint32_t event_count = 0;
 
-  while(1){
-    auto ev = reader->GetNextEvent();
-    if(!ev)
-      break;
-    bool in_range_evn = false;
-    if(eventl_v!=0 || eventh_v!=0){
-      uint32_t ev_n = ev->GetEventN();
-      if(ev_n >= eventl_v && ev_n < eventh_v){
-        in_range_evn = true;
-      }
+  if(stat_v){
+    Stats stats;
+    bool framed = false;
+    if(type_in == "native"){
+      eudaq::FileDeserializer des(infile_path);
+      framed = des.IsFramed();
     }
-    else
-      in_range_evn = true;
-
-    bool in_range_tgn = false;
-    if(triggerl_v!=0 || triggerh_v!=0){
-      uint32_t tg_n = ev->GetTriggerN();
-      if(tg_n >= triggerl_v && tg_n < triggerh_v){
-        in_range_tgn = true;
+    if(!framed){
+      eudaq::EventHeader h;
+      while(reader->GetNextHeader(h)){
+	event_count ++;
+	if(in_range(h.ev_n, h.tg_n, h.ts_begin, h.ts_end))
+	  stats.Add(h);
       }
+      stats.Print(std::cout);
+      std::cout<< "There are "<< event_count << "Events"<<std::endl;
+      return 0;
     }
-    else
-      in_range_tgn = true;
 
-    bool in_range_tsn = false;
-    if(timestampl_v!=0 || timestamph_v!=0){
-      uint32_t ts_beg = ev->GetTimestampBegin();
-      uint32_t ts_end = ev->GetTimestampEnd();
-      if(ts_beg >= timestampl_v && ts_end <= timestamph_v){
-        in_range_tsn = true;
+    // the file is read in parts, several at once, each reading only the
+    // event headers and seeking over the rest of their frames
+    const uint64_t part_bytes = 32 << 20;
+    std::deque<StatsPart> parts;
+    std::string error;
+    try{
+      for(auto &range: SplitFrames(infile_path, part_bytes)){
+	parts.emplace_back();
+	parts.back().begin = range.first;
+	parts.back().end = range.second;
       }
     }
-    else
-      in_range_tsn = true;
-
+    catch(const std::exception &e){
+      error = e.what();
+    }
+    for(auto &p: parts){
+      StatsPart *pp = &p;
+      eudaq::TaskPool::Instance().Submit([&infile_path, &in_range, pp](){
+	  try{
+	    eudaq::FileDeserializer des(infile_path, true);
+	    des.Seek(pp->begin);
+	    eudaq::EventHeader h;
+	    while(des.Tell() < pp->end && des.ReadHeader(h)){
+	      pp->n_read++;
+	      if(in_range(h.ev_n, h.tg_n, h.ts_begin, h.ts_end))
+		pp->stats.Add(h);
+	    }
+	  }
+	  catch(const std::exception &e){
+	    pp->error = e.what();
+	  }
+	});
+    }
+    eudaq::TaskPool::Instance().WaitIdle();
+    for(auto &p: parts){
+      stats.Merge(p.stats);
+      event_count += p.n_read;
+      if(error.empty())
+	error = p.error;
+    }
+    stats.Print(std::cout);
+    std::cout<< "There are "<< event_count << "Events"<<std::endl;
+    if(!error.empty()){
+      std::cerr<< "Error reading "<< infile_path <<": "<< error <<std::endl;
+      return 1;
+    }
+    return 0;
+  }
 
-    if((in_range_evn && in_range_tgn && in_range_tsn) && not_all_zero){
+  eudaq::StdEventSP evstd;
+  while(1){
+    auto ev = reader->GetNextEvent();
+    if(!ev)
+      break;
+    if(in_range(ev->GetEventN(), ev->GetTriggerN(), ev->GetTimestampBegin(), ev->GetTimestampEnd())
+       && not_all_zero){
       ev->Print(std::cout);
       if(stdev_v){
-        auto evstd = eudaq::StandardEvent::MakeShared();
+        if(!evstd)
+          evstd = eudaq::StandardEvent::MakeShared();
+        else
+          evstd->Recycle();
         eudaq::StdEventConverter::Convert(ev, evstd, nullptr);
         std::cout<< ">>>>>"<< evstd->NumPlanes() <<"<<<<"<<std::endl;
       }
     }
-    
+
     event_count ++;
   }
   std::cout<< "There are "<< event_count << "Events"<<std::endl;
@@ -0,0 +1,58 @@
+#ifndef EUDAQ_INCLUDED_Clusterizer
+#define EUDAQ_INCLUDED_Clusterizer
+
+#include "eudaq/Platform.hh"
+
+#include <vector>
+#include <cstdint>
+
+namespace eudaq {
+
+  /**
+   * Groups pixels into clusters of neighbours: two pixels are connected when
+   * they are at most max_dx columns and max_dy rows apart. The buffers are
+   * kept between Clear() calls, so one instance can be reused for every
+   * plane of every event.
+   *
+   * After Run(), GetLabels()[i] is the cluster of the i-th added pixel, and
+   * the pixels of cluster c are GetOrder()[GetOffsets()[c]] up to
+   * GetOrder()[GetOffsets()[c+1]].
+   */
+  class DLLEXPORT Clusterizer {
+  public:
+    Clusterizer(uint32_t max_dx = 1, uint32_t max_dy = 1);
+    void SetNeighbourDistance(uint32_t max_dx, uint32_t max_dy);
+    void Clear();
+    void AddPixel(int32_t x, int32_t y);
+    size_t Run();
+
+    size_t NumPixels() const {return m_pix.size();}
+    size_t NumClusters() const {return m_n_cluster;}
+    const std::vector<uint32_t> &GetLabels() const {return m_label;}
+    const std::vector<uint32_t> &GetOrder() const {return m_order;}
+    const std::vector<uint32_t> &GetOffsets() const {return m_offset;}
+
+  private:
+    struct Pixel {
+      uint64_t key; // column major, for sorting
+      int32_t x;
+      int32_t y;
+      uint32_t i;
+    };
+    uint32_t Find(uint32_t i);
+    void Unite(uint32_t a, uint32_t b);
+
+    uint32_t m_dx;
+    uint32_t m_dy;
+    size_t m_n_cluster;
+    std::vector<Pixel> m_pix;
+    std::vector<uint32_t> m_parent;
+    std::vector<uint32_t> m_root_label;
+    std::vector<uint32_t> m_label;
+    std::vector<uint32_t> m_order;
+    std::vector<uint32_t> m_offset;
+    std::vector<size_t> m_col;
+  };
+}
+
+#endif // EUDAQ_INCLUDED_Clusterizer
@@ -5,6 +5,7 @@
 #include "eudaq/Platform.hh"
 #include "eudaq/Configuration.hh"
 #include "eudaq/Logger.hh"
+#include "eudaq/Metrics.hh"
 
 #include <thread>
 #include <memory>
@@ -53,6 +54,7 @@ namespace eudaq {
 
     bool IsConnected() const;
     bool IsStatus(Status::State);
+    MetricRegistry &GetMetrics();
   private:
     void CommandHandler(TransportEvent &);
     bool Deamon();
@@ -81,6 +83,9 @@ namespace eudaq {
     std::shared_ptr<Configuration> m_conf_init;
     std::string m_type;
     std::string m_name;
+    std::string m_trace_file;
+    MetricRegistry m_metrics;
+    std::unique_ptr<MetricsEndpoint> m_metrics_endpoint;
     uint32_t m_run_number;
   };
 }
@@ -0,0 +1,15 @@
+#ifndef EUDAQ_INCLUDED_Crc32c
+#define EUDAQ_INCLUDED_Crc32c
+
+#include "eudaq/Platform.hh"
+#include <cstddef>
+#include <cstdint>
+
+namespace eudaq {
+  // CRC32C (Castagnoli) of data, continuing from crc, the result for the
+  // preceding bytes (0 to start). Uses the SSE 4.2 crc32 instruction where
+  // the CPU has it.
+  DLLEXPORT uint32_t Crc32c(uint32_t crc, const void *data, size_t len);
+}
+
+#endif // EUDAQ_INCLUDED_Crc32c
@@ -69,6 +69,11 @@ namespace eudaq {
     uint32_t m_dct_n;
     uint32_t m_evt_c;
     uint32_t m_fraction;
+    uint64_t m_file_bytes;
+    uint64_t m_late_c;
+    MetricCounter &m_mtr_evt;
+    MetricCounter &m_mtr_file_byte;
+    MetricCounter &m_mtr_mon_evt;
     ConfigurationSPC m_conf;
   };
   //----------DOC-MARK-----END*DEC-----DOC-MARK----------
@@ -36,6 +36,8 @@ namespace eudaq {
     virtual void OnDisconnect(ConnectionSPC id);
     virtual void OnReceive(ConnectionSPC id, EventSP ev);
     std::string Listen(const std::string &addr);
+    size_t GetQueueSize();
+    uint64_t GetDropCount() const;
     void StopListen();//TODO: remove this method later
   private:
     void DataHandler(TransportEvent &ev);
@@ -50,6 +52,7 @@ namespace eudaq {
     bool m_is_destructing;
     bool m_is_listening;
     bool m_is_async_rcv_return;
+    std::atomic<uint64_t> m_drop_c;
     std::future<bool> m_fut_async_rcv;
     std::future<bool> m_fut_async_fwd;
     std::future<bool> m_fut_deamon;
@@ -20,7 +20,7 @@ class TransportClient;
       DataSender(const std::string & type, const std::string & name);
       ~DataSender();
       void Connect(const std::string & server);
-      void SendEvent(EventSPC ev);
+      size_t SendEvent(EventSPC ev);
   private:
       bool AsyncSending();
       std::string m_type, m_name;
@@ -33,6 +33,8 @@ namespace eudaq{
     }
       
     void read(unsigned char *dst, size_t size);
+    // discards the next len bytes
+    virtual void Skip(size_t len);
     void PreRead(uint32_t &t);
     void PreRead(uint8_t *dst, size_t size);
   protected:
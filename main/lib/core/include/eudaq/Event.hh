@@ -32,6 +32,25 @@ namespace eudaq {
   using EventSP = Factory<Event>::SP_BASE;
   using EventSPC = Factory<Event>::SPC_BASE;
 
+  // The fixed fields of an event and the sizes of its blocks, for scanning
+  // files without copying the data.
+  struct EventHeader {
+    uint32_t type;
+    uint32_t version;
+    uint32_t flags;
+    uint32_t stm_n;
+    uint32_t run_n;
+    uint32_t ev_n;
+    uint32_t tg_n;
+    uint32_t extend;
+    uint64_t ts_begin;
+    uint64_t ts_end;
+    std::string dspt;
+    uint32_t n_block;
+    uint64_t block_bytes;
+    std::vector<EventHeader> sub_events;
+  };
+
   class DLLEXPORT Event : public Serializable{
   public:
     enum Flags {
@@ -102,8 +121,18 @@ namespace eudaq {
     std::string GetDescription() const;
 
     static EventUP MakeUnique(const std::string& dspt);
+    // dspt_hash is str2hash(dspt), e.g. a static cstr2hash at the call site
+    static EventUP MakeUnique(const std::string& dspt, uint32_t dspt_hash);
     static EventSP MakeShared(const std::string& dspt);
     static EventSP Make(const std::string& type, const std::string& argv);
+    // reads the next event of ds into h, skipping the block data of raw
+    // events; other event types are read in full
+    static void ReadHeader(Deserializer &ds, EventHeader &h);
+    // reads the part written by Event::Serialize of an event of any type,
+    // skipping the block data; what a derived class writes after it is
+    // left unread
+    static void ReadCommonHeader(Deserializer &ds, EventHeader &h);
+    void FillHeader(EventHeader &h) const;
 
     void SetEventID(uint32_t id);
     uint32_t GetEventID() const;
@@ -123,24 +152,31 @@ namespace eudaq {
     /// Add a data block as std::vector
     template <typename T>
     size_t AddBlock(uint32_t id, const std::vector<T> &data){
-      m_blocks[id]=make_vector(data);
+      const uint8_t *ptr = reinterpret_cast<const uint8_t *>(data.data());
+      BlockBuffer(id).assign(ptr, ptr + data.size() * sizeof(T));
       return m_blocks.size();
     }
 
     /// Add a data block as array with given size
     template <typename T>
     size_t AddBlock(uint32_t id, const T *data, size_t bytes){
-      m_blocks[id]=make_vector(data, bytes);
+      const uint8_t *ptr = reinterpret_cast<const uint8_t *>(data);
+      BlockBuffer(id).assign(ptr, ptr + bytes);
       return m_blocks.size();
     }
 
     template <typename T>
     void AppendBlock(size_t index, const std::vector<T> &data) {
-      auto &&src = make_vector(data);
-      auto &&dst = m_blocks[index];
-      dst.insert(dst.end(), src.begin(), src.end());
+      const uint8_t *ptr = reinterpret_cast<const uint8_t *>(data.data());
+      auto &&dst = BlockBuffer(index);
+      dst.insert(dst.end(), ptr, ptr + data.size() * sizeof(T));
     }
 
+    /// Keep n empty buffers of the given capacity for the next AddBlock calls
+    void ReserveBlocks(size_t n, size_t bytes);
+    /// Reset to a blank event, keeping the block buffers for reuse
+    virtual void Recycle();
+
     //TODO: remove, clearn up
     std::string GetTag(const std::string &name, const char *def) const;
     template <typename T> T GetTag(const std::string & name, T def) const {
@@ -151,17 +187,7 @@ namespace eudaq {
     }
     
   private:
-    template <typename T>
-      static std::vector<uint8_t> make_vector(const T *data, size_t bytes) {
-      const uint8_t *ptr = reinterpret_cast<const uint8_t *>(data);
-      return std::vector<uint8_t>(ptr, ptr + bytes);
-    }
-
-    template <typename T>
-    static std::vector<uint8_t> make_vector(const std::vector<T> &data) {
-      const uint8_t *ptr = reinterpret_cast<const uint8_t *>(&data[0]);
-      return std::vector<uint8_t>(ptr, ptr + data.size() * sizeof(T));
-    }
+    std::vector<uint8_t> &BlockBuffer(uint32_t id);
     
   private:
     uint32_t m_type;
@@ -178,6 +204,7 @@ namespace eudaq {
     std::map<std::string, std::string> m_tags;
     std::map<uint32_t, std::vector<uint8_t>> m_blocks;
     std::vector<EventSPC> m_sub_events;
+    std::vector<std::vector<uint8_t>> m_spare_blocks;
   };
 }
 
@@ -0,0 +1,48 @@
+#ifndef EUDAQ_INCLUDED_EventPool
+#define EUDAQ_INCLUDED_EventPool
+
+#include "eudaq/Event.hh"
+#include "eudaq/Platform.hh"
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+
+namespace eudaq {
+
+  /**
+   * Recycles RawEvent objects of one description.
+   * MakeUnique() behaves like Event::MakeUnique(dspt), but the event goes
+   * back to the pool, with its block buffers, once the last reference to it
+   * is dropped. The pool may be destroyed before its events.
+   */
+  class DLLEXPORT EventPool {
+  public:
+    EventPool(const std::string &dspt, size_t max_free = 1024,
+	      size_t n_block = 0, size_t block_bytes = 0);
+    EventPool(const EventPool&) = delete;
+    EventPool& operator = (const EventPool&) = delete;
+    ~EventPool();
+    EventUP MakeUnique();
+    EventSP MakeShared();
+    void ReserveBlocks(size_t n_block, size_t block_bytes);
+    size_t NumFree() const;
+
+  private:
+    struct Store {
+      std::mutex mtx;
+      std::vector<Event*> free;
+      size_t max_free;
+    };
+    static void Release(std::weak_ptr<Store> store, Event *ev);
+
+    std::shared_ptr<Store> m_store;
+    std::string m_dspt;
+    uint32_t m_dspt_hash;
+    size_t m_n_block;
+    size_t m_block_bytes;
+  };
+}
+
+#endif // EUDAQ_INCLUDED_EventPool
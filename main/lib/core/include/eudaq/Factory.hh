@@ -6,6 +6,9 @@
 #include <utility>
 #include <functional>
 #include <cstdint>
+#include <vector>
+#include <atomic>
+#include <mutex>
 
 namespace eudaq{
 
@@ -21,7 +24,10 @@ namespace eudaq{
     using SP = std::shared_ptr<BASE>;
     using WP = std::weak_ptr<BASE>;
     using SPC = std::shared_ptr<const BASE>;
-    
+
+    // owns with a plain delete, without the std::function deleter of UP_BASE
+    using UP_PLAIN = std::unique_ptr<BASE>;
+
     template <typename ...ARGS>
     static typename Factory<BASE>::UP_BASE
     MakeUnique(std::uint32_t id, ARGS&& ...args);
@@ -34,40 +40,121 @@ namespace eudaq{
     static typename Factory<BASE>::UP_BASE
     Create(std::uint32_t id, ARGS&& ...args);
 
+    template <typename ...ARGS>
+    static typename Factory<BASE>::UP_PLAIN
+    MakePlain(std::uint32_t id, ARGS&& ...args);
+
+    template <typename... ARGS>
+    static UP_BASE (*Find(std::uint32_t id))(ARGS&&...);
+
+    template <typename... ARGS>
+    static UP_PLAIN (*FindPlain(std::uint32_t id))(ARGS&&...);
+
     template <typename... ARGS>
       static std::map<std::uint32_t, UP_BASE (*)(ARGS&&...)>&
     Instance();
+
+    template <typename... ARGS>
+      static std::map<std::uint32_t, UP_PLAIN (*)(ARGS&&...)>&
+    PlainInstance();
     
     template <typename DERIVED, typename... ARGS>
     static std::uint64_t
     Register(std::uint32_t id);
     
+    /**
+     * Maker resolved once for a given id, e.g. kept as a static or a member
+     * next to the code that creates objects of one type at high rate.
+     */
+    template <typename... ARGS>
+    class Handle{
+    public:
+      explicit Handle(std::uint32_t id)
+	:m_id(id), m_fun(Find<ARGS...>(id)){}
+      UP_BASE operator()(ARGS&& ...args) const {
+	auto fun = m_fun ? m_fun : Find<ARGS...>(m_id);
+	if(!fun){
+	  std::cerr<<"Factory::Handle: Unknown class ID: <"<<m_id<<">\n";
+	  return nullptr;
+	}
+	return fun(std::forward<ARGS>(args)...);
+      }
+      std::uint32_t GetID() const {return m_id;}
+    private:
+      std::uint32_t m_id;
+      UP_BASE (*m_fun)(ARGS&&...);
+    };
+    
   private:
     template <typename DERIVED, typename... ARGS>
       static UP_BASE MakerFun(ARGS&& ...args){
       return UP_BASE(new DERIVED(std::forward<ARGS>(args)...), [](BASE *p) {delete p; });
     }
+    template <typename DERIVED, typename... ARGS>
+      static UP_PLAIN PlainFun(ARGS&& ...args){
+      return UP_PLAIN(new DERIVED(std::forward<ARGS>(args)...));
+    }
+
+    // Open-addressing copy of Instance(), built at the first lookup after
+    // the plugins have registered and replaced when a registration changes.
+    template <typename... ARGS>
+    struct FlatTable{
+      std::vector<std::pair<std::uint32_t, UP_BASE (*)(ARGS...)>> slots;
+      std::vector<UP_PLAIN (*)(ARGS...)> plain; // by slot, as in PlainInstance()
+      std::uint32_t shift;
+    };
+    template <typename... ARGS>
+    struct FlatStore{
+      std::atomic<const FlatTable<ARGS...>*> table{nullptr};
+      std::mutex mtx;
+      std::vector<std::unique_ptr<const FlatTable<ARGS...>>> tables;
+    };
+    template <typename... ARGS>
+    static FlatStore<ARGS...>& Flat(){
+      static FlatStore<ARGS...> store;
+      return store;
+    }
+    template <typename... ARGS>
+    static const FlatTable<ARGS...>* BuildFlat();
+    template <typename... ARGS>
+    static std::size_t FindSlot(std::uint32_t id, const FlatTable<ARGS...>* &table);
+    static std::size_t Slot(std::uint32_t id, std::uint32_t shift){
+      return static_cast<std::uint32_t>(id * 2654435769u) >> shift;
+    }
   };
 
   template <typename BASE>
   template <typename ...ARGS>
   typename Factory<BASE>::UP_BASE
   Factory<BASE>::MakeUnique(std::uint32_t id, ARGS&& ...args){
-    auto &ins = Instance<ARGS&&...>();
-    auto it = ins.find(id);
-    if (it == ins.end()){
-      std::cerr<<"Factory<"<<static_cast<const void *>(&ins)<<">: "
+    auto fun = Find<ARGS&&...>(id);
+    if (!fun){
+      std::cerr<<"Factory<"<<static_cast<const void *>(&Instance<ARGS&&...>())<<">: "
+	       <<" Unknown class ID: <"<<id<<">\n";
+      return nullptr;
+    }
+    return fun(std::forward<ARGS>(args)...);
+  };
+
+  template <typename BASE>
+  template <typename ...ARGS>
+  typename Factory<BASE>::UP_PLAIN
+  Factory<BASE>::MakePlain(std::uint32_t id, ARGS&& ...args){
+    auto fun = FindPlain<ARGS&&...>(id);
+    if (!fun){
+      std::cerr<<"Factory<"<<static_cast<const void *>(&Instance<ARGS&&...>())<<">: "
 	       <<" Unknown class ID: <"<<id<<">\n";
       return nullptr;
     }
-    return (it->second)(std::forward<ARGS>(args)...);
+    return fun(std::forward<ARGS>(args)...);
   };
 
+  // the shared_ptr keeps a plain delete instead of a copy of the std::function
   template <typename BASE>
   template <typename ...ARGS>
   typename Factory<BASE>::SP_BASE
   Factory<BASE>::MakeShared(std::uint32_t id, ARGS&& ...args){
-    SP_BASE sp = MakeUnique(id, std::forward<ARGS>(args)...);
+    SP_BASE sp = MakePlain(id, std::forward<ARGS>(args)...);
     return sp;
   }
 
@@ -78,6 +165,80 @@ namespace eudaq{
   Factory<BASE>::Create(std::uint32_t id, ARGS&& ...args){
     return MakeUnique(id, std::forward<ARGS>(args)...);
   }
+
+  template <typename BASE>
+  template <typename... ARGS>
+  const typename Factory<BASE>::template FlatTable<ARGS...>*
+  Factory<BASE>::BuildFlat(){
+    auto &store = Flat<ARGS...>();
+    std::unique_lock<std::mutex> lk(store.mtx);
+    auto table = store.table.load(std::memory_order_acquire);
+    if(table)
+      return table;
+    auto &ins = Instance<ARGS...>();
+    std::unique_ptr<FlatTable<ARGS...>> flat(new FlatTable<ARGS...>);
+    std::uint32_t bits = 1;
+    while((std::size_t(1) << bits) < ins.size() * 2)
+      bits++;
+    flat->shift = 32 - bits;
+    flat->slots.resize(std::size_t(1) << bits);
+    flat->plain.resize(flat->slots.size());
+    std::size_t mask = flat->slots.size() - 1;
+    auto &plain = PlainInstance<ARGS...>();
+    for(auto &e: ins){
+      std::size_t i = Slot(e.first, flat->shift);
+      while(flat->slots[i].second)
+	i = (i + 1) & mask;
+      flat->slots[i] = e;
+      auto it = plain.find(e.first);
+      if(it != plain.end())
+	flat->plain[i] = it->second;
+    }
+    table = flat.get();
+    // tables are never freed before the factory, a lookup may still hold one
+    store.tables.push_back(std::move(flat));
+    store.table.store(table, std::memory_order_release);
+    return table;
+  }
+
+  // slot of id in the flat table, or the size of the table if id is unknown
+  template <typename BASE>
+  template <typename... ARGS>
+  std::size_t Factory<BASE>::FindSlot(std::uint32_t id, const FlatTable<ARGS...>* &table){
+    auto &store = Flat<ARGS...>();
+    table = store.table.load(std::memory_order_acquire);
+    if(!table)
+      table = BuildFlat<ARGS...>();
+    for(bool rebuilt = false; ; rebuilt = true){
+      std::size_t mask = table->slots.size() - 1;
+      for(std::size_t i = Slot(id, table->shift); table->slots[i].second; i = (i + 1) & mask){
+	if(table->slots[i].first == id)
+	  return i;
+      }
+      // Not in the table: unknown, or registered by a module loaded later.
+      // The table is rebuilt at once, so later lookups of the id hit it.
+      if(rebuilt || !Instance<ARGS...>().count(id))
+	return table->slots.size();
+      store.table.compare_exchange_strong(table, nullptr, std::memory_order_acq_rel);
+      table = BuildFlat<ARGS...>();
+    }
+  }
+
+  template <typename BASE>
+  template <typename... ARGS>
+  typename Factory<BASE>::UP_BASE (*Factory<BASE>::Find(std::uint32_t id))(ARGS&&...){
+    const FlatTable<ARGS&&...> *table;
+    std::size_t i = FindSlot<ARGS&&...>(id, table);
+    return i < table->slots.size() ? table->slots[i].second : nullptr;
+  }
+
+  template <typename BASE>
+  template <typename... ARGS>
+  typename Factory<BASE>::UP_PLAIN (*Factory<BASE>::FindPlain(std::uint32_t id))(ARGS&&...){
+    const FlatTable<ARGS&&...> *table;
+    std::size_t i = FindSlot<ARGS&&...>(id, table);
+    return i < table->slots.size() ? table->plain[i] : nullptr;
+  }
   
   template <typename BASE>
   template <typename... ARGS>
@@ -91,6 +252,14 @@ namespace eudaq{
     }
     return m;
   };
+
+  template <typename BASE>
+  template <typename... ARGS>
+  std::map<std::uint32_t, typename Factory<BASE>::UP_PLAIN (*)(ARGS&&...)>&
+  Factory<BASE>::PlainInstance(){
+    static std::map<std::uint32_t, typename Factory<BASE>::UP_PLAIN (*)(ARGS&&...)> m;
+    return m;
+  };
     
   template <typename BASE>
   template <typename DERIVED, typename... ARGS>
@@ -100,6 +269,8 @@ namespace eudaq{
     // std::cout<<"Register ID "<<id <<"  to Factory<"
     // 	     <<static_cast<const void *>(&ins)<<">    ";
     ins[id] = &MakerFun<DERIVED, ARGS&&...>;
+    PlainInstance<ARGS&&...>()[id] = &PlainFun<DERIVED, ARGS&&...>;
+    Flat<ARGS&&...>().table.store(nullptr, std::memory_order_release);
     // std::cout<<"   map items: ";
     // for(auto& e: ins)
     //   std::cout<<e.first<<"  ";
@@ -16,15 +16,42 @@ namespace eudaq{
                      size_t buffersize = 65536);
     ~FileDeserializer();
     virtual bool HasData();
+    void Skip(size_t len) override;
     bool ReadEvent(int ver, EventSP &ev, size_t skip = 0);
-    
+    // next event of a native file, nullptr at the end
+    EventUP ReadEvent();
+    bool ReadHeader(EventHeader &h);
+    // seeks over the next event in framed files, reads it in full otherwise
+    bool SkipEvent();
+    // whether the events are framed with their length (NATIVE_FILE_MAGIC)
+    bool IsFramed();
+    // NATIVE_FILE_VERSION of a framed file
+    uint32_t FormatVersion();
+    // bytes of the next frame of a framed file, events and footers alike,
+    // with the checksum at the end in version 2; false at the end
+    bool ReadFrame(std::vector<uint8_t> &frame);
+    // bytes consumed from the file
+    uint64_t Tell() const { return m_file_pos - level(); }
+    // continues reading at byte pos of the file
+    void Seek(uint64_t pos);
+    uint64_t FileSize();
+
   private:
     virtual void Deserialize(uint8_t *data, size_t len);
     virtual void PreDeserialize(uint8_t *data, size_t len);
     size_t FillBuffer(size_t min = 0);
     size_t level() const { return m_stop - m_start; }
+    bool DetectFormat();
+    // goes to the next event frame, passing over footers
+    bool NextFrame(uint64_t &end);
+    void EndFrame(uint64_t end);
     FILE *m_file;
     bool m_faileof;
+    bool m_detected;
+    bool m_framed;
+    uint32_t m_version;
+    uint64_t m_file_pos;
+    uint64_t m_file_size;
     std::vector<uint8_t> m_buf;
     uint8_t *m_start;
     uint8_t *m_stop;
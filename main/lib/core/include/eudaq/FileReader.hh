@@ -30,6 +30,11 @@ namespace eudaq{
     void SetConfiguration(ConfigurationSPC c) {m_conf = c;};
     ConfigurationSPC GetConfiguration() const {return m_conf;};
     virtual EventSPC GetNextEvent() {return nullptr;};
+    // header of the next event, cheaper than GetNextEvent where the reader
+    // can skip the block data; false at the end
+    virtual bool GetNextHeader(EventHeader &h);
+    // passes over the next n events, returns how many there were
+    virtual uint64_t SkipEvents(uint64_t n);
     static FileReaderSP Make(std::string type, std::string path);
   private:
     ConfigurationSPC m_conf;
@@ -10,17 +10,39 @@
 #include <cstdio>
 
 namespace eudaq {
+  // A native file starting with these two words frames every event with
+  // its length (uint64_t), so that readers can seek over it. Files without
+  // them are a plain sequence of events. From version 2 on, the last 4
+  // bytes of every frame are the CRC32C of the bytes before them.
+  const uint32_t NATIVE_FILE_MAGIC = 0x4e515545; // "EUQN"
+  const uint32_t NATIVE_FILE_VERSION = 2;
+
   class DLLEXPORT FileSerializer : public Serializer {
   public:
-    FileSerializer(const std::string &fname, bool overwrite = false);
+    // io "stdio" writes through fwrite. "direct" (Linux) collects the data
+    // in aligned buffers of buffer_size bytes, which a thread writes with
+    // pwritev, using O_DIRECT where the file system allows it; Flush() then
+    // has no effect and the file is complete once destroyed. Elsewhere
+    // "direct" falls back to stdio.
+    FileSerializer(const std::string &fname, bool overwrite = false,
+                   const std::string &io = "stdio",
+                   size_t buffer_size = 4 << 20);
     virtual void Flush();
     uint64_t FileBytes() const { return m_filebytes; }
+    // CRC32C of the bytes written since the last ResetCheckSum(); none is
+    // computed before the first call
+    uint64_t GetCheckSum() override { return m_crc; }
+    void ResetCheckSum() { m_crc = 0; m_crc_on = true; }
     ~FileSerializer();
 
   private:
+    struct DirectWriter;
     virtual void Serialize(const uint8_t *data, size_t len);
     FILE *m_file;
+    std::unique_ptr<DirectWriter> m_direct;
     uint64_t m_filebytes;
+    bool m_crc_on;
+    uint32_t m_crc;
   };
 
 }
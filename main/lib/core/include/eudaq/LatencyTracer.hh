@@ -0,0 +1,119 @@
+#ifndef EUDAQ_INCLUDED_LatencyTracer
+#define EUDAQ_INCLUDED_LatencyTracer
+
+#include "eudaq/Platform.hh"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <deque>
+#include <array>
+#include <memory>
+#include <mutex>
+#include <atomic>
+
+namespace eudaq {
+
+  /**
+   * Optional per-event latency trace points along the data path.
+   * Each thread writes into its own single-producer ring buffer, so a trace
+   * point costs two clock reads and a few stores. The rings are drained
+   * into per-stage histograms whenever a summary or a trace file is asked
+   * for (typically from OnStatus).
+   */
+  class DLLEXPORT LatencyTracer {
+  public:
+    enum Stage {
+      STAGE_PRODUCER_SEND,
+      STAGE_RECEIVER_DECODE,
+      STAGE_COLLECTOR_WRITE,
+      STAGE_FILE_WRITE,
+      STAGE_MONITOR_RECEIVE,
+      STAGE_N // The last value, any additions should go before this
+    };
+
+    struct Record {
+      uint64_t t_begin;
+      uint64_t t_end;
+      uint32_t ev_n;
+      uint32_t stage;
+    };
+
+    static LatencyTracer &Instance();
+    static uint64_t Now();
+    static std::string Stage2String(uint32_t stage);
+
+    void SetEnabled(bool enable);
+    bool IsEnabled() const {return m_enabled.load(std::memory_order_relaxed);}
+    void Trace(Stage stage, uint32_t ev_n, uint64_t t_begin, uint64_t t_end);
+
+    std::map<std::string, std::string> GetSummary();
+    void WriteChromeTrace(const std::string &path);
+    void Reset();
+
+  private:
+    static const size_t RING_SIZE = 4096; // must be a power of two
+    static const size_t HIST_BINS = 40;   // log2(ns) buckets
+    static const size_t KEEP_RECORDS = 65536;
+
+    struct Ring {
+      std::array<Record, RING_SIZE> buf;
+      std::atomic<uint64_t> head;
+      std::atomic<uint64_t> tail;
+      std::atomic<uint64_t> dropped;
+      std::atomic_bool exited; // the writing thread is gone
+      uint32_t tid;
+    };
+
+    // marks the ring of a thread when the thread exits, so Drain can
+    // drop it once it is empty
+    struct RingHolder {
+      std::shared_ptr<Ring> ring;
+      ~RingHolder(){
+	if(ring)
+	  ring->exited = true;
+      }
+    };
+
+    struct Histogram {
+      std::array<uint64_t, HIST_BINS> bins;
+      uint64_t n;
+      uint64_t sum_ns;
+      uint64_t max_ns;
+    };
+
+    LatencyTracer();
+    Ring &ThreadRing();
+    void Drain();
+    uint64_t Quantile(const Histogram &h, double q) const;
+
+    std::atomic_bool m_enabled;
+    std::mutex m_mtx_rings;
+    std::vector<std::shared_ptr<Ring>> m_rings;
+    uint32_t m_next_tid;
+    std::mutex m_mtx_drain;
+    std::array<Histogram, STAGE_N> m_hists;
+    std::deque<std::pair<uint32_t, Record>> m_records;
+    uint64_t m_dropped;
+  };
+
+  class DLLEXPORT LatencyTraceScope {
+  public:
+    LatencyTraceScope(LatencyTracer::Stage stage, uint32_t ev_n = 0)
+      :m_stage(stage), m_ev_n(ev_n), m_t_begin(0){
+      if(LatencyTracer::Instance().IsEnabled())
+	m_t_begin = LatencyTracer::Now();
+    }
+    ~LatencyTraceScope(){
+      if(m_t_begin)
+	LatencyTracer::Instance().Trace(m_stage, m_ev_n, m_t_begin, LatencyTracer::Now());
+    }
+    void SetEventN(uint32_t ev_n){m_ev_n = ev_n;}
+  private:
+    LatencyTracer::Stage m_stage;
+    uint32_t m_ev_n;
+    uint64_t m_t_begin;
+  };
+}
+
+#endif // EUDAQ_INCLUDED_LatencyTracer
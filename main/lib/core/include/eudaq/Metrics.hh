@@ -0,0 +1,89 @@
+#ifndef EUDAQ_INCLUDED_Metrics
+#define EUDAQ_INCLUDED_Metrics
+
+#include "eudaq/Platform.hh"
+
+#include <string>
+#include <map>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <functional>
+
+namespace eudaq {
+
+  /**
+   * Monotonic counter, safe to bump from any thread without locking.
+   * The registry derives a sliding-window rate from it.
+   */
+  class DLLEXPORT MetricCounter {
+  public:
+    MetricCounter(const std::string &unit = "") :m_value(0), m_unit(unit){}
+    void Add(uint64_t n = 1){m_value.fetch_add(n, std::memory_order_relaxed);}
+    uint64_t Get() const {return m_value.load(std::memory_order_relaxed);}
+    void Reset(){m_value.store(0, std::memory_order_relaxed);}
+    const std::string &Unit() const {return m_unit;}
+  private:
+    std::atomic<uint64_t> m_value;
+    std::string m_unit;
+  };
+
+  /**
+   * Last-value metric, e.g. a queue depth or a file size.
+   */
+  class DLLEXPORT MetricGauge {
+  public:
+    MetricGauge() :m_value(0){}
+    void Set(int64_t v){m_value.store(v, std::memory_order_relaxed);}
+    void Add(int64_t n){m_value.fetch_add(n, std::memory_order_relaxed);}
+    int64_t Get() const {return m_value.load(std::memory_order_relaxed);}
+    void Reset(){m_value.store(0, std::memory_order_relaxed);}
+  private:
+    std::atomic<int64_t> m_value;
+  };
+
+  class DLLEXPORT MetricRegistry {
+  public:
+    MetricRegistry(double window_s = 10.);
+    MetricCounter &Counter(const std::string &name, const std::string &unit = "");
+    MetricGauge &Gauge(const std::string &name);
+    void SetWindow(double window_s);
+    void Reset();
+
+    std::map<std::string, std::string> GetStatusTags();
+    std::string GetPrometheusText(const std::string &labels = "");
+
+  private:
+    struct Sample {
+      double t;
+      uint64_t v;
+    };
+    double Rate(const std::string &name, const MetricCounter &c, double now);
+
+    std::mutex m_mtx;
+    double m_window;
+    std::map<std::string, std::unique_ptr<MetricCounter>> m_counters;
+    std::map<std::string, std::unique_ptr<MetricGauge>> m_gauges;
+    std::map<std::string, std::deque<Sample>> m_samples;
+  };
+
+  /**
+   * Minimal HTTP listener answering every request with the text from the
+   * callback, meant to be scraped by Prometheus ("GET /metrics").
+   */
+  class DLLEXPORT MetricsEndpoint {
+  public:
+    MetricsEndpoint(uint16_t port, std::function<std::string()> text);
+    ~MetricsEndpoint();
+  private:
+    void Serving();
+    std::function<std::string()> m_text;
+    int m_fd;
+    std::atomic_bool m_go_stop;
+    std::thread m_th;
+  };
+}
+
+#endif // EUDAQ_INCLUDED_Metrics
@@ -14,6 +14,7 @@
 #include <list>
 #include <memory>
 #include <atomic>
+#include <chrono>
 
 namespace eudaq {
   class Monitor;
@@ -40,9 +41,16 @@ namespace eudaq {
     virtual void DoStatus();
     virtual void DoReceive(EventSP ev);
     void SetServerAddress(const std::string &addr);
+    void SetTargetLoad(double load);
+    double GetSampleFraction() const;
     static MonitorSP Make(const std::string &code_name,
 			  const std::string &run_name,
 			  const std::string &runcontrol);
+  protected:
+    // for monitors analysing the events on their own threads: the time spent
+    // there feeds the prescale, events given up later lower the fraction
+    void AddBusyTime(double sec);
+    void CountDropped();
   private:
     void OnInitialise() override final;
     void OnConfigure() override final;
@@ -52,9 +60,25 @@ namespace eudaq {
     void OnTerminate() override final;
     void OnStatus() override final;
     void OnReceive(ConnectionSPC id, EventSP ev) override final;
+  private:
+    bool Sample();
+    void UpdateSampling();
   private:
     std::string m_data_addr;
     uint32_t m_evt_c;
+    MetricCounter &m_mtr_evt;
+
+    // adaptive prescale: accept a fraction of the events so that the
+    // analysis takes about m_target_load of the wall time, 0 accepts everything
+    double m_target_load;
+    double m_fraction;
+    double m_credit;
+    std::atomic<uint64_t> m_busy_ns;
+    uint64_t m_win_rec_c;
+    std::chrono::steady_clock::time_point m_win_start;
+    std::atomic<uint64_t> m_rec_c;
+    std::atomic<uint64_t> m_acc_c;
+    std::atomic<uint64_t> m_drop_c;
   };
   //----------DOC-MARK-----END*DEC-----DOC-MARK----------
 }
@@ -0,0 +1,58 @@
+#ifndef EUDAQ_INCLUDED_NativeFileIndex
+#define EUDAQ_INCLUDED_NativeFileIndex
+
+#include "eudaq/Serializable.hh"
+#include "eudaq/Serializer.hh"
+#include "eudaq/Deserializer.hh"
+#include "eudaq/Event.hh"
+#include "eudaq/Platform.hh"
+
+#include <string>
+#include <vector>
+#include <map>
+
+namespace eudaq {
+
+  // The last frame of a native file (chunk) holds its NativeFileIndex,
+  // starting with NATIVE_FOOTER_ID and ending with the offset of that frame
+  // and NATIVE_FOOTER_MAGIC, followed by the frame checksum in version 2.
+  const uint32_t NATIVE_FOOTER_ID = 0x58444e49; // "INDX"
+  const uint32_t NATIVE_FOOTER_MAGIC = 0x54464f45; // "EOFT"
+
+  /**
+   * Offsets of the events in a native file and what they hold: event and
+   * trigger number ranges, timestamp range and events per stream.
+   * Triggers and timestamps are taken from the events and their sub-events
+   * having FLAG_TRIG and FLAG_TIME.
+   */
+  class DLLEXPORT NativeFileIndex : public Serializable {
+  public:
+    NativeFileIndex();
+    NativeFileIndex(Deserializer &ds);
+    void Serialize(Serializer &ser) const override;
+    void Add(const Event &ev, uint64_t offset);
+    void Clear();
+    uint64_t NumEvents() const {return m_offsets.size();};
+    // reads the footer of the native file at path; false if it has none,
+    // e.g. when the writer did not close it. Throws if the footer is broken
+    // or, from version 2 on, its checksum does not match
+    static bool ReadFooter(const std::string &path, NativeFileIndex &idx);
+
+    std::vector<uint64_t> m_offsets;
+    uint32_t m_ev_first;
+    uint32_t m_ev_last;
+    bool m_has_tg;
+    uint32_t m_tg_min;
+    uint32_t m_tg_max;
+    bool m_has_ts;
+    uint64_t m_ts_min;
+    uint64_t m_ts_max;
+    // events per description and stream number
+    std::map<std::string, std::map<uint32_t, uint64_t>> m_streams;
+
+  private:
+    void AddStreams(const Event &ev);
+  };
+}
+
+#endif // EUDAQ_INCLUDED_NativeFileIndex
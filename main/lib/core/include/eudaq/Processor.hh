@@ -4,15 +4,17 @@
 #include <set>
 #include <vector>
 #include <string>
-#include <queue>
 #include <memory>
 #include <thread>
 #include <mutex>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 
 #include "Event.hh"
 #include "Factory.hh"
+#include "TaskPool.hh"
+#include "Metrics.hh"
 
 namespace eudaq {
   class Processor;
@@ -28,6 +30,18 @@ namespace eudaq {
   using ProcessorSP = Factory<Processor>::SP_BASE;
   using ProcessorWP = Factory<Processor>::WP_BASE;
   
+  /**
+   * Processors run on the shared TaskPool. Events registered to a processor
+   * wait in its input queue and are handed to ProcessEvent in batches by a
+   * pool task. By default a processor sees its events one at a time in
+   * arrival order; one that opts out (SYS:OD:OFF, or SetOrdered(false)) may
+   * get batches on several pool threads at once. The queue belongs to the
+   * receiving processor and is shared by all its upstreams.
+   * The input queue is bounded (SYS:QU:SIZE, 0 for no limit). When it is
+   * full the upstream waits, helping to empty it (SYS:QU:POLICY=block), the event is dropped
+   * (drop), or, from half full on, only every SYS:QU:SAMPLE-th event is
+   * kept (sample).
+   */
   class DLLEXPORT Processor: public std::enable_shared_from_this<Processor>{
   public:
     static ProcessorSP MakeShared(const std::string& pstype,
@@ -58,39 +72,54 @@ namespace eudaq {
     ProcessorSP operator-(const std::string& evtype);
     ProcessorSP operator<<=(EventSPC ev);
 
+  protected:
+    // false lets ProcessEvent run on several pool threads at once
+    void SetOrdered(bool ordered){m_ordered = ordered;};
+
   private:
-    void Processing(EventSPC ev);
-    void ConsumeEvent();
-    void HubProcessing(); //relay
+    enum class QueuePolicy {BLOCK, DROP, SAMPLE};
+    struct QueuedEvent {
+      EventSPC ev;
+      std::chrono::steady_clock::time_point t_in;
+    };
+    using Downstreams = std::vector<std::pair<ProcessorSP, std::set<uint32_t>>>;
+    void Drain();
+    bool Consume();
+    void Release();
+    bool AcceptEvent();
     void ProcessSysCommand(const std::string& cmd, const std::string& arg);
-    void RegisterProcessing(ProcessorSP ps, EventSPC ev);
     void RegisterDownstream(ProcessorSP ps, const std::set<uint32_t>& evset = {});
-    void RegisterUpstream(ProcessorSP up, ProcessorWP hub);
+    void RegisterUpstream(ProcessorSP up);
     
   private:
     std::string m_description;
     uint32_t m_instance_n;
     
-    ProcessorWP m_ps_hub;
     std::vector<ProcessorWP> m_ps_upstream;
-    std::vector<std::pair<ProcessorSP, std::set<uint32_t>>> m_ps_downstream;
-    std::mutex m_mtx_input;  // m_ps_upstream, m_ps_hub; guard the event intput
-    std::mutex m_mtx_output; // m_ps_downstream; guard the event output
-    // std::mutex m_mtx_config;
-    
-    std::atomic_bool m_hub_force;
-    
-    std::deque<EventSPC> m_que_csm;
-    std::deque<std::pair<ProcessorSP, EventSPC> > m_que_hub;
-    std::mutex m_mtx_csm;
-    std::mutex m_mtx_hub;
-    std::condition_variable m_cv_csm;
-    std::condition_variable m_cv_hub;
-    std::thread m_th_csm;
-    std::thread m_th_hub;
+    std::shared_ptr<const Downstreams> m_ps_downstream; // copy on write
+    std::mutex m_mtx_input;  // m_ps_upstream
+    std::mutex m_mtx_output; // writers of m_ps_downstream
+
+    MpscQueue<QueuedEvent> m_que_in;
+    std::atomic_bool m_scheduled; // a Drain task is pending
+    std::atomic_bool m_consuming; // whoever set it owns the pop side of m_que_in
+    std::atomic_bool m_ordered;
+    std::atomic<int64_t> m_que_size;
+    std::atomic<QueuePolicy> m_que_policy;
+    std::atomic<uint32_t> m_sample_n;
+    std::atomic<uint64_t> m_sample_c;
+    std::atomic<uint32_t> m_n_wait;
+    std::mutex m_mtx_space;
+    std::condition_variable m_cv_space;
+
+    MetricCounter m_met_in;
+    MetricCounter m_met_drop;
+    MetricCounter m_met_done;
+    MetricCounter m_met_wait_ns; // summed time in the input queue
+    MetricGauge m_met_wait_max_ns;
+    MetricCounter m_met_proc_ns; // summed time in ProcessEvent
+    MetricGauge m_met_depth_max;
     std::thread m_th_pdc;
-    std::atomic_bool m_csm_go_stop;
-    std::atomic_bool m_hub_go_stop;
     std::atomic_bool m_pdc_go_stop;
     
     std::set<uint32_t> m_ev_out_default;
@@ -57,6 +57,8 @@ namespace eudaq {
   private:
     uint32_t m_pdc_n;
     uint32_t m_evt_c;
+    MetricCounter &m_mtr_evt;
+    MetricCounter &m_mtr_byte;
     std::mutex m_mtx_sender;
     std::map<std::string, std::shared_ptr<DataSender>> m_senders;
   };
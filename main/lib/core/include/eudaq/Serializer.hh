@@ -148,6 +148,16 @@ namespace eudaq {
     write(t->first);
     write(t->second);
   }
+
+  // counts the bytes written to it, e.g. to prefix a record with its length
+  class CountingSerializer : public Serializer {
+  public:
+    CountingSerializer():m_bytes(0){}
+    uint64_t Bytes() const {return m_bytes;}
+  private:
+    void Serialize(const uint8_t *, size_t len) override {m_bytes += len;}
+    uint64_t m_bytes;
+  };
 }
 
 #endif // EUDAQ_INCLUDED_Serializer
@@ -23,17 +23,22 @@ namespace eudaq {
     StandardEvent(Deserializer &);
 
     StandardPlane &AddPlane(const StandardPlane &);
+    StandardPlane &AddPlane(StandardPlane &&);
+    StandardPlane &AddPlane(uint32_t id, const std::string &type,
+			    const std::string &sensor = "");
     size_t NumPlanes() const;
     const StandardPlane &GetPlane(size_t i) const;
     StandardPlane &GetPlane(size_t i);
     virtual void Serialize(Serializer &) const;
     virtual void Print(std::ostream & os,size_t offset = 0) const;
+    void Recycle() override;
     
     static StdEventSP MakeShared();    
     static const uint32_t m_id_factory = cstr2hash("StandardEvent");
 
   private:
     std::vector<StandardPlane> m_planes;
+    std::vector<StandardPlane> m_spare_planes;
   };
 
   inline std::ostream &operator<<(std::ostream &os, const StandardPlane &pl) {
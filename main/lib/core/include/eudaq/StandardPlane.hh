@@ -29,6 +29,12 @@ namespace eudaq {
                   const std::string &sensor = "");
     StandardPlane(Deserializer &);
     StandardPlane();
+    StandardPlane(const StandardPlane &);
+    StandardPlane(StandardPlane &&) noexcept;
+    StandardPlane &operator=(const StandardPlane &);
+    StandardPlane &operator=(StandardPlane &&) noexcept;
+    void Reset(uint32_t id, const std::string &type,
+	       const std::string &sensor = "");
     void Serialize(Serializer &) const;
     void SetSizeRaw(uint32_t w, uint32_t h, uint32_t frames = 1, int flags = 0);
     void SetSizeZS(uint32_t w, uint32_t h, uint32_t npix, uint32_t frames = 1,
@@ -108,6 +114,7 @@ namespace eudaq {
     const std::vector<pixel_t> &
       GetFrame(const std::vector<std::vector<pixel_t>> &v, uint32_t f) const;
     void SetupResult() const;
+    void ClearResult() const;
 
     std::string m_type;
     std::string m_sensor;
@@ -0,0 +1,113 @@
+#ifndef EUDAQ_INCLUDED_TaskPool
+#define EUDAQ_INCLUDED_TaskPool
+
+#include "eudaq/Platform.hh"
+
+#include <deque>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <condition_variable>
+
+namespace eudaq {
+
+  /**
+   * Unbounded multi-producer single-consumer queue without locks.
+   * Push() may be called from any thread, Pop() only from the one thread
+   * currently owning the consumer side.
+   */
+  template <typename T>
+  class MpscQueue {
+  public:
+    MpscQueue():m_size(0){
+      m_tail = new Node;
+      m_head.store(m_tail);
+    }
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator = (const MpscQueue&) = delete;
+    ~MpscQueue(){
+      T v;
+      while(Pop(v));
+      delete m_tail;
+    }
+    void Push(T v){
+      Node *n = new Node;
+      n->value = std::move(v);
+      Node *prev = m_head.exchange(n, std::memory_order_acq_rel);
+      prev->next.store(n, std::memory_order_release);
+      m_size++;
+    }
+    bool Pop(T &v){
+      Node *next = m_tail->next.load(std::memory_order_acquire);
+      if(!next)
+	return false;
+      v = std::move(next->value);
+      next->value = T();
+      delete m_tail;
+      m_tail = next;
+      m_size--;
+      return true;
+    }
+    // may be briefly off by the pushes and pops in flight
+    int64_t Size() const {return m_size.load();}
+
+  private:
+    struct Node {
+      Node():next(nullptr){};
+      std::atomic<Node*> next;
+      T value;
+    };
+    std::atomic<Node*> m_head;
+    Node *m_tail;
+    std::atomic<int64_t> m_size;
+  };
+
+  /**
+   * Fixed set of worker threads, each with its own task deque.
+   * A task submitted from a worker goes to that worker's deque, other
+   * tasks are spread round robin. A worker runs its newest task first and
+   * steals the oldest task of another worker when its own deque is empty;
+   * it sleeps when there is nothing to run anywhere.
+   */
+  class DLLEXPORT TaskPool {
+  public:
+    using Task = std::function<void()>;
+    static TaskPool& Instance();
+    // size of Instance(), only effective before its first use; 0 for one
+    // worker per core
+    static void SetDefaultNumWorkers(uint32_t n);
+
+    explicit TaskPool(uint32_t n_worker = 0);
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator = (const TaskPool&) = delete;
+    ~TaskPool();
+    void Submit(Task t);
+    // blocks until every submitted task has finished; not from a worker
+    void WaitIdle();
+    uint32_t GetNumWorkers() const {return m_workers.size();};
+
+  private:
+    struct Worker {
+      std::mutex mtx;
+      std::deque<Task> que;
+      std::thread th;
+    };
+    void Run(uint32_t n);
+    bool PopTask(uint32_t n, Task &t);
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::atomic<uint32_t> m_next;
+    std::atomic<int64_t> m_queued;
+    std::atomic<int64_t> m_pending;
+    std::atomic<uint32_t> m_sleeping;
+    std::mutex m_mtx_sleep;
+    std::condition_variable m_cv_sleep;
+    std::condition_variable m_cv_idle;
+    bool m_exit;
+  };
+}
+
+#endif // EUDAQ_INCLUDED_TaskPool
@@ -0,0 +1,117 @@
+#include "eudaq/Clusterizer.hh"
+
+#include <algorithm>
+#include <limits>
+
+namespace eudaq {
+
+  namespace{
+    const uint32_t NO_LABEL = std::numeric_limits<uint32_t>::max();
+  }
+
+  Clusterizer::Clusterizer(uint32_t max_dx, uint32_t max_dy)
+    :m_dx(max_dx), m_dy(max_dy), m_n_cluster(0){
+  }
+
+  void Clusterizer::SetNeighbourDistance(uint32_t max_dx, uint32_t max_dy){
+    m_dx = max_dx;
+    m_dy = max_dy;
+  }
+
+  void Clusterizer::Clear(){
+    m_pix.clear();
+    m_label.clear();
+    m_order.clear();
+    m_offset.clear();
+    m_n_cluster = 0;
+  }
+
+  void Clusterizer::AddPixel(int32_t x, int32_t y){
+    uint64_t key = (uint64_t(uint32_t(x) ^ 0x80000000u) << 32) | (uint32_t(y) ^ 0x80000000u);
+    m_pix.push_back(Pixel{key, x, y, static_cast<uint32_t>(m_pix.size())});
+  }
+
+  uint32_t Clusterizer::Find(uint32_t i){
+    while(m_parent[i] != i){
+      m_parent[i] = m_parent[m_parent[i]];
+      i = m_parent[i];
+    }
+    return i;
+  }
+
+  void Clusterizer::Unite(uint32_t a, uint32_t b){
+    a = Find(a);
+    b = Find(b);
+    if(a < b)
+      m_parent[b] = a;
+    else if(b < a)
+      m_parent[a] = b;
+  }
+
+  size_t Clusterizer::Run(){
+    const size_t n = m_pix.size();
+    std::sort(m_pix.begin(), m_pix.end(),
+	      [](const Pixel &l, const Pixel &r){return l.key < r.key;});
+    m_parent.resize(n);
+    for(size_t j = 0; j < n; j++)
+      m_parent[j] = j;
+
+    // Walk the columns in order. Inside a column the pixels are sorted by
+    // row, so each pixel only has to be compared with its predecessor and,
+    // in each of the last m_dx columns, with a window that moves forward.
+    m_col.clear();
+    size_t col_begin = 0;
+    while(col_begin < n){
+      const int64_t x = m_pix[col_begin].x;
+      size_t col_end = col_begin + 1;
+      while(col_end < n && m_pix[col_end].x == x)
+	col_end++;
+
+      size_t n_drop = 0;
+      while(n_drop < m_col.size() && x - m_pix[m_col[n_drop]].x > int64_t(m_dx))
+	n_drop++;
+      m_col.erase(m_col.begin(), m_col.begin() + n_drop);
+
+      for(size_t j = col_begin + 1; j < col_end; j++)
+	if(int64_t(m_pix[j].y) - m_pix[j-1].y <= int64_t(m_dy))
+	  Unite(j, j-1);
+
+      for(size_t c = 0; c < m_col.size(); c++){
+	size_t k = m_col[c];
+	const int64_t xp = m_pix[k].x;
+	for(size_t j = col_begin; j < col_end; j++){
+	  const int64_t y = m_pix[j].y;
+	  while(k < n && m_pix[k].x == xp && m_pix[k].y < y - int64_t(m_dy))
+	    k++;
+	  for(size_t m = k; m < n && m_pix[m].x == xp && m_pix[m].y <= y + int64_t(m_dy); m++)
+	    Unite(j, m);
+	}
+      }
+      m_col.push_back(col_begin);
+      col_begin = col_end;
+    }
+
+    m_root_label.assign(n, NO_LABEL);
+    m_label.resize(n);
+    m_offset.assign(1, 0);
+    m_n_cluster = 0;
+    for(size_t j = 0; j < n; j++){
+      uint32_t root = Find(j);
+      if(m_root_label[root] == NO_LABEL){
+	m_root_label[root] = m_n_cluster++;
+	m_offset.push_back(0);
+      }
+      uint32_t lab = m_root_label[root];
+      m_label[m_pix[j].i] = lab;
+      m_offset[lab + 1]++;
+    }
+    for(size_t c = 0; c < m_n_cluster; c++)
+      m_offset[c + 1] += m_offset[c];
+    // m_root_label now holds the next free slot of each cluster
+    m_order.resize(n);
+    m_root_label.assign(m_offset.begin(), m_offset.end() - 1);
+    for(size_t j = 0; j < n; j++)
+      m_order[m_root_label[m_label[m_pix[j].i]]++] = m_pix[j].i;
+    return m_n_cluster;
+  }
+}
@@ -4,7 +4,9 @@
 #include "eudaq/Exception.hh"
 #include "eudaq/Logger.hh"
 #include "eudaq/Utils.hh"
+#include "eudaq/FileNamer.hh"
 #include "eudaq/CommandReceiver.hh"
+#include "eudaq/LatencyTracer.hh"
 #include <iostream>
 #include <ostream>
 
@@ -98,6 +100,21 @@ namespace eudaq {
   }
   
   void CommandReceiver::OnConfigure(){
+    if(m_conf){
+      LatencyTracer::Instance().SetEnabled(m_conf->Get("EUDAQ_TRACE", 0));
+      m_trace_file = m_conf->Get("EUDAQ_TRACE_FILE", "");
+      m_metrics.SetWindow(m_conf->Get("EUDAQ_METRICS_WINDOW", 10.));
+      uint16_t port = m_conf->Get("EUDAQ_METRICS_PORT", 0);
+      if(port && !m_metrics_endpoint){
+	try{
+	  std::string labels = "component=\"" + GetFullName() + "\"";
+	  m_metrics_endpoint.reset(new MetricsEndpoint(port, [this, labels](){
+		return m_metrics.GetPrometheusText(labels);}));
+	}catch(const Exception &e){
+	  EUDAQ_WARN(std::string("CommandReceiver: metrics endpoint is disabled: ") + e.what());
+	}
+      }
+    }
     SetStatus(Status::STATE_CONF, "Configured");
     EUDAQ_INFO(GetFullName() + " is configured.");
   }
@@ -128,6 +145,15 @@ namespace eudaq {
       }
       m_fut_runloop.get();
     }
+    if(LatencyTracer::Instance().IsEnabled() && !m_trace_file.empty()){
+      try{
+	LatencyTracer::Instance().WriteChromeTrace(FileNamer(m_trace_file).
+						   Set('R', GetRunNumber()).
+						   Set('X', ".json"));
+      }catch(const Exception &e){
+	EUDAQ_WARN(std::string("CommandReceiver: latency trace is not written: ") + e.what());
+      }
+    }
     SetStatus(Status::STATE_CONF, "Stopped");
     EUDAQ_INFO("RUN #" + std::to_string(GetRunNumber()) + " is stopped.");
   }
@@ -158,7 +184,12 @@ namespace eudaq {
   }
 
   void CommandReceiver::OnStatus(){
-
+    for(auto &tag: m_metrics.GetStatusTags())
+      SetStatusTag(tag.first, tag.second);
+    if(LatencyTracer::Instance().IsEnabled()){
+      for(auto &tag: LatencyTracer::Instance().GetSummary())
+	SetStatusTag(tag.first, tag.second);
+    }
   }
   
   void CommandReceiver::OnUnrecognised(const std::string & /*cmd*/, const std::string & /*param*/){
@@ -206,6 +237,10 @@ namespace eudaq {
   bool CommandReceiver::IsConnected() const{
     return m_is_connected;
   }
+
+  MetricRegistry &CommandReceiver::GetMetrics(){
+    return m_metrics;
+  }
   
   void CommandReceiver::RunLoop(){
     //default, just waiting
@@ -289,6 +324,10 @@ namespace eudaq {
         OnConfigure();
       } else if (cmd == "START") {
 	m_run_number = from_string(param, 0);
+	// before the derived OnStartRun, which may already count in DoStartRun
+	m_metrics.Reset();
+	if(LatencyTracer::Instance().IsEnabled())
+	  LatencyTracer::Instance().Reset();
         OnStartRun();
       } else if (cmd == "STOP") {
         OnStopRun();
@@ -0,0 +1,84 @@
+#include "eudaq/Crc32c.hh"
+
+#include <cstring>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <nmmintrin.h>
+#define EUDAQ_CRC32C_SSE42
+#endif
+
+namespace eudaq {
+  namespace{
+    const uint32_t POLY = 0x82f63b78; // reflected Castagnoli polynomial
+
+    struct Tables {
+      uint32_t t[8][256];
+      Tables(){
+	for(uint32_t i = 0; i < 256; i++){
+	  uint32_t c = i;
+	  for(int k = 0; k < 8; k++)
+	    c = (c & 1) ?(c >> 1) ^ POLY :c >> 1;
+	  t[0][i] = c;
+	}
+	for(uint32_t i = 0; i < 256; i++)
+	  for(int s = 1; s < 8; s++)
+	    t[s][i] = (t[s-1][i] >> 8) ^ t[0][t[s-1][i] & 0xff];
+      }
+    };
+
+    // slicing by 8, for CPUs without the instruction
+    uint32_t Crc32cSoft(uint32_t c, const uint8_t *p, size_t len){
+      static const Tables tb;
+      const uint32_t (*t)[256] = tb.t;
+      while(len && (reinterpret_cast<uintptr_t>(p) & 7)){
+	c = t[0][(c ^ *p++) & 0xff] ^ (c >> 8);
+	len--;
+      }
+      while(len >= 8){
+	uint32_t lo, hi;
+	std::memcpy(&lo, p, 4);
+	std::memcpy(&hi, p + 4, 4);
+	lo ^= c;
+	c = t[7][lo & 0xff] ^ t[6][(lo >> 8) & 0xff] ^ t[5][(lo >> 16) & 0xff] ^ t[4][lo >> 24] ^
+	  t[3][hi & 0xff] ^ t[2][(hi >> 8) & 0xff] ^ t[1][(hi >> 16) & 0xff] ^ t[0][hi >> 24];
+	p += 8;
+	len -= 8;
+      }
+      while(len--)
+	c = t[0][(c ^ *p++) & 0xff] ^ (c >> 8);
+      return c;
+    }
+
+#ifdef EUDAQ_CRC32C_SSE42
+    __attribute__((target("sse4.2")))
+    uint32_t Crc32cHard(uint32_t c, const uint8_t *p, size_t len){
+      while(len && (reinterpret_cast<uintptr_t>(p) & 7)){
+	c = _mm_crc32_u8(c, *p++);
+	len--;
+      }
+      uint64_t c64 = c;
+      while(len >= 8){
+	uint64_t v;
+	std::memcpy(&v, p, 8);
+	c64 = _mm_crc32_u64(c64, v);
+	p += 8;
+	len -= 8;
+      }
+      c = static_cast<uint32_t>(c64);
+      while(len--)
+	c = _mm_crc32_u8(c, *p++);
+      return c;
+    }
+    const bool s_hard = __builtin_cpu_supports("sse4.2");
+#endif
+  }
+
+  uint32_t Crc32c(uint32_t crc, const void *data, size_t len){
+    const uint8_t *p = static_cast<const uint8_t *>(data);
+#ifdef EUDAQ_CRC32C_SSE42
+    if(s_hard)
+      return ~Crc32cHard(~crc, p, len);
+#endif
+    return ~Crc32cSoft(~crc, p, len);
+  }
+}
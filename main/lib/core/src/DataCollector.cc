@@ -1,5 +1,6 @@
 #include "eudaq/DataCollector.hh"
 #include "eudaq/Logger.hh"
+#include "eudaq/LatencyTracer.hh"
 #include "eudaq/Utils.hh"
 #include <iostream>
 #include <ostream>
@@ -12,10 +13,15 @@ namespace eudaq {
   Factory<DataCollector>::Instance<const std::string&, const std::string&>(); //TODO
   
   DataCollector::DataCollector(const std::string &name, const std::string &runcontrol)
-    :CommandReceiver("DataCollector", name, runcontrol){
+    :CommandReceiver("DataCollector", name, runcontrol),
+     m_mtr_evt(GetMetrics().Counter("Events")),
+     m_mtr_file_byte(GetMetrics().Counter("FileBytes", "B")),
+     m_mtr_mon_evt(GetMetrics().Counter("MonitorEvents")){
     m_dct_n= str2hash(GetFullName());
     m_evt_c = 0;
     m_fraction = 1;
+    m_file_bytes = 0;
+    m_late_c = 0;
   }
 
   DataCollector::~DataCollector(){  
@@ -95,8 +101,12 @@ namespace eudaq {
     try {
       m_data_addr = Listen(m_data_addr);
       SetStatusTag("_SERVER", m_data_addr);
-      m_writer = Factory<FileWriter>::Create<std::string&>(str2hash(m_fwtype), m_fwpatt);
+      FileWriterSP writer = Factory<FileWriter>::Create<std::string&>(str2hash(m_fwtype), m_fwpatt);
+      writer->SetConfiguration(GetConfiguration());
+      std::atomic_store(&m_writer, writer);
       m_evt_c = 0;
+      m_file_bytes = 0;
+      m_late_c = 0;
 
       std::string mn_str = GetConfiguration()->Get("EUDAQ_MN", "");
       std::vector<std::string> col_mn_name = split(mn_str, ";,", true);
@@ -130,6 +140,8 @@ namespace eudaq {
       m_senders.clear();
       lk.unlock();
       StopListen();
+      // closes the file, writers finish it in their destructor
+      std::atomic_store(&m_writer, FileWriterSP());
       CommandReceiver::OnStopRun();
     } catch (const Exception &e) {
       std::string msg = "Error stopping for run " + std::to_string(GetRunNumber()) + ": " + e.what();
@@ -165,10 +177,10 @@ namespace eudaq {
   void DataCollector::OnStatus(){
     SetStatusTag("EventN", std::to_string(m_evt_c));
     SetStatusTag("MonitorEventN", std::to_string(float(m_evt_c/m_fraction)));
+    GetMetrics().Gauge("ReceiveQueue").Set(GetQueueSize());
+    GetMetrics().Gauge("ReceiveDropped").Set(GetDropCount());
     DoStatus();
-    // if(m_writer && m_writer->FileBytes()){
-    //   SetStatusTag("FILEBYTES", std::to_string(m_writer->FileBytes()));
-    // }
+    CommandReceiver::OnStatus();
   }
 
   void DataCollector::OnConnect(ConnectionSPC id){
@@ -184,7 +196,16 @@ namespace eudaq {
   }  
     
   void DataCollector::WriteEvent(EventSP ev){
+    // keyed on the number the event arrived with, as in the receiver stage
+    LatencyTraceScope trace(LatencyTracer::STAGE_COLLECTOR_WRITE, ev->GetEventN());
     try{
+      auto file_writer = std::atomic_load(&m_writer);
+      if(!file_writer){
+	// the file is closed at stop-run, later events are dropped
+	if(!m_late_c++)
+	  EUDAQ_WARN("DataCollector: no file is open, events arriving outside a run are not written");
+	return;
+      }
       if(ev->IsBORE()){
 	if(GetConfiguration())
 	  ev->SetTag("EUDAQ_CONFIG", to_string(*GetConfiguration()));
@@ -196,17 +217,21 @@ namespace eudaq {
       ev->SetEventN(m_evt_c);
       m_evt_c ++;
       ev->SetStreamN(m_dct_n);
-      auto file_writer = m_writer;
-      if(file_writer)
-	file_writer->WriteEvent(ev);
-      else
-	EUDAQ_THROW("FileWriter is not created before writing.");
+      file_writer->WriteEvent(ev);
+      m_mtr_evt.Add();
+      uint64_t file_bytes = file_writer->FileBytes();
+      if(file_bytes > m_file_bytes)
+	m_mtr_file_byte.Add(file_bytes - m_file_bytes);
+      // a writer starting a new file counts from zero again
+      m_file_bytes = file_bytes;
       std::unique_lock<std::mutex> lk(m_mtx_sender);
       auto senders = m_senders;
       lk.unlock();
       if(m_evt_c%m_fraction != 0){
 	return;
       }
+      if(!senders.empty())
+	m_mtr_mon_evt.Add();
       for(auto &e: senders){
 	if(e.second)
 	  e.second->SendEvent(ev);
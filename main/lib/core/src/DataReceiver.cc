@@ -2,6 +2,7 @@
 #include "eudaq/TransportServer.hh"
 #include "eudaq/BufferSerializer.hh"
 #include "eudaq/Logger.hh"
+#include "eudaq/LatencyTracer.hh"
 #include "eudaq/Utils.hh"
 #include <iostream>
 #include <ostream>
@@ -10,7 +11,7 @@
 namespace eudaq {
   
   DataReceiver::DataReceiver()
-    :m_is_listening(false),m_is_destructing(false), m_last_addr("tcp://0"){
+    :m_is_listening(false),m_is_destructing(false), m_last_addr("tcp://0"), m_drop_c(0){
   }
 
   DataReceiver::~DataReceiver(){
@@ -92,15 +93,19 @@ namespace eudaq {
 	m_cv_not_empty.notify_all();
       }
       else{ //identified connection  
+	LatencyTraceScope trace(LatencyTracer::STAGE_RECEIVER_DECODE);
 	BufferSerializer ser(ev.packet.begin(), ev.packet.end());
 	uint32_t id;
 	ser.PreRead(id);
 	auto ev_con = std::make_pair<EventSP, ConnectionSPC>
-	  (Factory<Event>::MakeUnique<Deserializer&>(id, ser), con);
+	  (Factory<Event>::MakePlain<Deserializer&>(id, ser), con);
+	if(ev_con.first)
+	  trace.SetEventN(ev_con.first->GetEventN());
 	std::unique_lock<std::mutex> lk(m_mx_qu_ev);
 	m_qu_ev.push(ev_con);
 	if(m_qu_ev.size() > 50000){
 	  m_qu_ev.pop();
+	  m_drop_c ++;
 	  EUDAQ_WARN("DataReceiver: Buffer of receving event is full.");
 	}
 	m_cv_not_empty.notify_all();
@@ -159,6 +164,15 @@ namespace eudaq {
     return 0;
   }
   
+  size_t DataReceiver::GetQueueSize(){
+    std::unique_lock<std::mutex> lk(m_mx_qu_ev);
+    return m_qu_ev.size();
+  }
+
+  uint64_t DataReceiver::GetDropCount() const{
+    return m_drop_c;
+  }
+
   std::string DataReceiver::Listen(const std::string &addr){
     std::unique_lock<std::mutex> lk_deamon(m_mx_deamon);
     if(!m_fut_deamon.valid())
@@ -78,7 +78,7 @@ namespace eudaq {
     m_fut_async = std::async(std::launch::async, &DataSender::AsyncSending, this);
   }
 
-  void DataSender::SendEvent(EventSPC ev){
+  size_t DataSender::SendEvent(EventSPC ev){
     if (!m_dataclient)
       EUDAQ_THROW("DataSender:: Transport not connected error");
 
@@ -97,6 +97,7 @@ namespace eudaq {
     m_packetCounter += 1;
     //TODO: catch exception below
     m_dataclient->SendPacket(ser);
+    return ser.size();
   }
 
   bool DataSender::AsyncSending(){
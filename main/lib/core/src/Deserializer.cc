@@ -15,6 +15,15 @@ namespace eudaq{
     Deserialize(dst, size);
   }
 
+  void Deserializer::Skip(size_t len){
+    unsigned char buf[4096];
+    while(len){
+      size_t n = len < sizeof(buf) ?len :sizeof(buf);
+      Deserialize(buf, n);
+      len -= n;
+    }
+  }
+
   void Deserializer::PreRead(uint32_t &t){
       unsigned char buf[sizeof(uint32_t)];
       PreDeserialize(buf, sizeof(uint32_t)); // 1.x serializer is little-endian (same to intel)
@@ -13,9 +13,15 @@ namespace eudaq {
   Factory<Event>::Instance<>();
 
   EventUP Event::MakeUnique(const std::string& dspt){
-    EventUP ev = Factory<Event>::MakeUnique<>(cstr2hash("RawEvent"));
-    ev->SetType(cstr2hash("RawEvent"));
-    ev->SetExtendWord(eudaq::str2hash(dspt));
+    return MakeUnique(dspt, eudaq::str2hash(dspt));
+  }
+
+  EventUP Event::MakeUnique(const std::string& dspt, uint32_t dspt_hash){
+    static constexpr uint32_t raw_id = cstr2hash("RawEvent");
+    static const Factory<Event>::Handle<> maker(raw_id);
+    EventUP ev = maker();
+    ev->SetType(raw_id);
+    ev->SetExtendWord(dspt_hash);
     ev->SetDescription(dspt);
     return ev;
   }
@@ -60,12 +66,76 @@ namespace eudaq {
     for(ds.read(n_subev); n_subev>0; n_subev--){
       uint32_t evid;
       ds.PreRead(evid);
-      EventSP ev = Factory<Event>::Create<Deserializer&>(evid, ds);
+      EventSP ev = Factory<Event>::MakePlain<Deserializer&>(evid, ds);
       m_sub_events.push_back(std::const_pointer_cast<const Event>(ev));
     }
   }
 
 
+  void Event::ReadHeader(Deserializer &ds, EventHeader &h){
+    uint32_t id;
+    ds.PreRead(id);
+    if(id != cstr2hash("RawEvent")){
+      EventUP ev = Factory<Event>::Create<Deserializer&>(id, ds);
+      if(!ev)
+	EUDAQ_THROW("ReadHeader: unknown event type " + std::to_string(id));
+      ev->FillHeader(h);
+      return;
+    }
+    ReadCommonHeader(ds, h);
+  }
+
+  void Event::ReadCommonHeader(Deserializer &ds, EventHeader &h){
+    ds.read(h.type);
+    ds.read(h.version);
+    ds.read(h.flags);
+    ds.read(h.stm_n);
+    ds.read(h.run_n);
+    ds.read(h.ev_n);
+    ds.read(h.tg_n);
+    ds.read(h.extend);
+    ds.read(h.ts_begin);
+    ds.read(h.ts_end);
+    ds.read(h.dspt);
+    std::map<std::string, std::string> tags;
+    ds.read(tags);
+    ds.read(h.n_block);
+    h.block_bytes = 0;
+    for(uint32_t i = 0; i < h.n_block; i++){
+      uint32_t id, len;
+      ds.read(id);
+      ds.read(len);
+      ds.Skip(len);
+      h.block_bytes += len;
+    }
+    uint32_t n_subev;
+    ds.read(n_subev);
+    h.sub_events.resize(n_subev);
+    for(auto &sub: h.sub_events)
+      ReadHeader(ds, sub);
+  }
+
+  void Event::FillHeader(EventHeader &h) const {
+    h.type = m_type;
+    h.version = m_version;
+    h.flags = m_flags;
+    h.stm_n = m_stm_n;
+    h.run_n = m_run_n;
+    h.ev_n = m_ev_n;
+    h.tg_n = m_tg_n;
+    h.extend = m_extend;
+    h.ts_begin = m_ts_begin;
+    h.ts_end = m_ts_end;
+    h.dspt = m_dspt;
+    h.n_block = m_blocks.size();
+    h.block_bytes = 0;
+    for(auto &b: m_blocks)
+      h.block_bytes += b.second.size();
+    h.sub_events.resize(m_sub_events.size());
+    for(size_t i = 0; i < m_sub_events.size(); i++)
+      m_sub_events[i]->FillHeader(h.sub_events[i]);
+  }
+
   void Event::AddSubEvent(EventSPC ev){
     bool exist = false;
     for(auto &e : m_sub_events){
@@ -112,6 +182,42 @@ namespace eudaq {
     return it->second;
   }
 
+  std::vector<uint8_t> &Event::BlockBuffer(uint32_t id){
+    auto it = m_blocks.find(id);
+    if(it != m_blocks.end())
+      return it->second;
+    auto &buf = m_blocks[id];
+    if(!m_spare_blocks.empty()){
+      buf.swap(m_spare_blocks.back());
+      m_spare_blocks.pop_back();
+    }
+    return buf;
+  }
+
+  void Event::ReserveBlocks(size_t n, size_t bytes){
+    for(size_t i = 0; i < n; i++){
+      m_spare_blocks.emplace_back();
+      m_spare_blocks.back().reserve(bytes);
+    }
+  }
+
+  void Event::Recycle(){
+    m_flags = 0;
+    m_stm_n = 0;
+    m_run_n = 0;
+    m_ev_n = 0;
+    m_tg_n = 0;
+    m_ts_begin = 0;
+    m_ts_end = 0;
+    m_tags.clear();
+    m_sub_events.clear();
+    for(auto &e: m_blocks){
+      e.second.clear();
+      m_spare_blocks.push_back(std::move(e.second));
+    }
+    m_blocks.clear();
+  }
+
   std::vector<uint32_t> Event::GetBlockNumList() const {
     std::vector<uint32_t> vnum;
     for(auto &e : m_blocks){
@@ -0,0 +1,70 @@
+#include "eudaq/EventPool.hh"
+#include "eudaq/RawEvent.hh"
+
+namespace eudaq {
+
+  EventPool::EventPool(const std::string &dspt, size_t max_free,
+		       size_t n_block, size_t block_bytes)
+    :m_store(std::make_shared<Store>()), m_dspt(dspt), m_dspt_hash(str2hash(dspt)),
+     m_n_block(n_block), m_block_bytes(block_bytes){
+    m_store->max_free = max_free;
+  }
+
+  EventPool::~EventPool(){
+    std::unique_lock<std::mutex> lk(m_store->mtx);
+    for(auto ev: m_store->free)
+      delete ev;
+    m_store->free.clear();
+    m_store->max_free = 0;
+  }
+
+  void EventPool::Release(std::weak_ptr<Store> wstore, Event *ev){
+    auto store = wstore.lock();
+    if(store){
+      std::unique_lock<std::mutex> lk(store->mtx);
+      if(store->free.size() < store->max_free){
+	lk.unlock();
+	ev->Recycle();
+	lk.lock();
+	store->free.push_back(ev);
+	return;
+      }
+    }
+    delete ev;
+  }
+
+  EventUP EventPool::MakeUnique(){
+    Event *ev = nullptr;
+    std::unique_lock<std::mutex> lk(m_store->mtx);
+    if(!m_store->free.empty()){
+      ev = m_store->free.back();
+      m_store->free.pop_back();
+    }
+    lk.unlock();
+    if(!ev){
+      ev = new RawEvent;
+      ev->SetExtendWord(m_dspt_hash);
+      ev->SetDescription(m_dspt);
+      ev->ReserveBlocks(m_n_block, m_block_bytes);
+    }
+    std::weak_ptr<Store> wstore = m_store;
+    return EventUP(ev, [wstore](Event *p){Release(wstore, p);});
+  }
+
+  EventSP EventPool::MakeShared(){
+    return MakeUnique();
+  }
+
+  void EventPool::ReserveBlocks(size_t n_block, size_t block_bytes){
+    m_n_block = n_block;
+    m_block_bytes = block_bytes;
+    std::unique_lock<std::mutex> lk(m_store->mtx);
+    for(auto ev: m_store->free)
+      ev->ReserveBlocks(n_block, block_bytes);
+  }
+
+  size_t EventPool::NumFree() const {
+    std::unique_lock<std::mutex> lk(m_store->mtx);
+    return m_store->free.size();
+  }
+}
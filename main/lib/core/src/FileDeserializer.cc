@@ -1,4 +1,6 @@
 #include "eudaq/FileDeserializer.hh"
+#include "eudaq/FileSerializer.hh"
+#include "eudaq/NativeFileIndex.hh"
 #include "eudaq/Logger.hh"
 #include "eudaq/Platform.hh"
 #include "eudaq/Utils.hh"
@@ -6,12 +8,13 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <iostream>
+#include <algorithm>
 
 namespace eudaq {
   FileDeserializer::FileDeserializer(const std::string &fname, bool faileof,
                                      size_t buffersize)
-      : m_file(0), m_faileof(faileof), m_buf(buffersize), m_start(&m_buf[0]),
-        m_stop(m_start) {
+      : m_file(0), m_faileof(faileof), m_detected(false), m_framed(false),
+        m_version(0), m_file_pos(0), m_file_size(0), m_buf(buffersize), m_start(&m_buf[0]), m_stop(m_start) {
     m_file = fopen(fname.c_str(), "rb");
     if (!m_file)
       EUDAQ_THROWX(FileNotFoundException, "Unable to open file: " + fname);
@@ -35,9 +38,153 @@ namespace eudaq {
   bool FileDeserializer::HasData() {
     if (level() == 0)
       FillBuffer();
+    if (!m_detected && !DetectFormat())
+      return false;
     return level() > 0;
   }
 
+  bool FileDeserializer::DetectFormat() {
+    uint32_t word[2];
+    if (level() < sizeof(word))
+      FillBuffer();
+    // a file still being written may not have its first words yet
+    if (level() < sizeof(word))
+      return false;
+    m_detected = true;
+    PreRead(word[0]);
+    if (word[0] != NATIVE_FILE_MAGIC)
+      return true;
+    read(word[0]);
+    read(word[1]);
+    if (word[1] > NATIVE_FILE_VERSION)
+      EUDAQ_THROWX(FileReadException, "Native file format version " +
+                   to_string(word[1]) + " is newer than this reader");
+    m_framed = true;
+    m_version = word[1];
+    return true;
+  }
+
+  uint32_t FileDeserializer::FormatVersion() {
+    return IsFramed() ? m_version : 0;
+  }
+
+  bool FileDeserializer::ReadFrame(std::vector<uint8_t> &frame) {
+    if (!HasData() || !m_framed)
+      return false;
+    uint64_t len;
+    read(len);
+    // a broken length must not allocate the world
+    if (len > m_file_size - std::min(m_file_size, Tell()))
+      m_file_size = FileSize();
+    if (len > m_file_size - std::min(m_file_size, Tell()))
+      EUDAQ_THROWX(FileReadException, "Frame of " + to_string(len) +
+                   " bytes beyond the end of the file at byte " + to_string(Tell()));
+    frame.resize(len);
+    if (len)
+      read(&frame[0], len);
+    return true;
+  }
+
+  bool FileDeserializer::IsFramed() {
+    if (!m_detected)
+      HasData();
+    return m_framed;
+  }
+
+  bool FileDeserializer::NextFrame(uint64_t &end) {
+    while (HasData()) {
+      uint64_t len;
+      read(len);
+      end = Tell() + len;
+      uint32_t id;
+      PreRead(id);
+      if (id != NATIVE_FOOTER_ID)
+        return true;
+      EndFrame(end);
+    }
+    return false;
+  }
+
+  uint64_t FileDeserializer::FileSize() {
+    if (fseek(m_file, 0L, SEEK_END) != 0)
+      EUDAQ_THROWX(FileReadException, "seek to end failed");
+    uint64_t size = ftell(m_file);
+    if (fseek(m_file, m_file_pos, SEEK_SET) != 0)
+      EUDAQ_THROWX(FileReadException, "seek back failed");
+    return size;
+  }
+
+  void FileDeserializer::Seek(uint64_t pos) {
+    if (!m_detected)
+      HasData();
+    if (fseek(m_file, pos, SEEK_SET) != 0)
+      EUDAQ_THROWX(FileReadException, "seek to " + to_string(pos) + " failed");
+    m_start = m_stop = &m_buf[0];
+    m_file_pos = pos;
+  }
+
+  void FileDeserializer::EndFrame(uint64_t end) {
+    uint64_t pos = Tell();
+    if (pos > end)
+      EUDAQ_THROWX(FileReadException, "Event overruns its frame at byte " +
+                   to_string(end));
+    // left by event types newer than this reader
+    Skip(end - pos);
+  }
+
+  EventUP FileDeserializer::ReadEvent() {
+    uint32_t id;
+    uint64_t end;
+    while (HasData()) {
+      if (!m_framed) {
+        PreRead(id);
+        return Factory<Event>::Create<Deserializer&>(id, *this);
+      }
+      if (!NextFrame(end))
+        break;
+      PreRead(id);
+      EventUP ev = Factory<Event>::Create<Deserializer&>(id, *this);
+      EndFrame(end);
+      if (ev)
+        return ev;
+      EUDAQ_WARN("Skipping an event of unknown type " + to_string(id));
+    }
+    return nullptr;
+  }
+
+  bool FileDeserializer::ReadHeader(EventHeader &h) {
+    if (!HasData())
+      return false;
+    if (!m_framed) {
+      Event::ReadHeader(*this, h);
+      return true;
+    }
+    uint64_t end;
+    if (!NextFrame(end))
+      return false;
+    Event::ReadCommonHeader(*this, h);
+    EndFrame(end);
+    return true;
+  }
+
+  bool FileDeserializer::SkipEvent() {
+    if (!HasData())
+      return false;
+    if (m_framed) {
+      uint64_t end;
+      if (!NextFrame(end))
+        return false;
+      EndFrame(end);
+      return true;
+    }
+    uint32_t id;
+    PreRead(id);
+    if (!Factory<Event>::Create<Deserializer&>(id, *this))
+      EUDAQ_THROWX(FileReadException, "Unable to skip an event of unknown type " +
+                   to_string(id));
+    return true;
+  }
+
   size_t FileDeserializer::FillBuffer(size_t min) {
     clearerr(m_file);
     if (level() == 0)
@@ -57,6 +204,7 @@ namespace eudaq {
     size_t read =
         fread(reinterpret_cast<char *>(m_stop), 1, end - m_stop, m_file);
     m_stop += read;
+    m_file_pos += read;
     while (read < min) {
       if (feof(m_file) && m_faileof) {
         throw FileReadException("End of File encountered");
@@ -73,6 +221,7 @@ namespace eudaq {
           fread(reinterpret_cast<char *>(m_stop), 1, end - m_stop, m_file);
       read += bytes;
       m_stop += bytes;
+      m_file_pos += bytes;
     }
     return read;
   }
@@ -101,6 +250,20 @@ namespace eudaq {
     }
   }
 
+  void FileDeserializer::Skip(size_t len) {
+    if (len <= level()) {
+      m_start += len;
+      return;
+    }
+    len -= level();
+    m_start = m_stop = &m_buf[0];
+    // seek over what is not buffered; a stream that cannot seek is read
+    if (len >= m_buf.size() && fseek(m_file, len, SEEK_CUR) == 0)
+      m_file_pos += len;
+    else
+      Deserializer::Skip(len);
+  }
+
   void FileDeserializer::PreDeserialize(uint8_t *data, size_t len) {
     if (len <= level()) {
       memcpy(data, m_start, len);
@@ -118,13 +281,13 @@ namespace eudaq {
       return false;
     }
     if (ver < 2) {
-      for (size_t i = 0; i <= skip; ++i) {
-        if (!HasData())
-          break;
-	uint32_t id;
-	PreRead(id);
-	ev = Factory<Event>::Create<Deserializer&>(id, *this);
+      for (size_t i = 0; i < skip; ++i) {
+        if (!SkipEvent())
+          return false;
       }
+      ev = ReadEvent();
+      if (!ev)
+        return false;
     } else {
       BufferSerializer buf;
       for (size_t i = 0; i <= skip; ++i) {
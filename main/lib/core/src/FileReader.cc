@@ -16,6 +16,22 @@ namespace eudaq {
   FileReader::~FileReader(){ 
   }
 
+  bool FileReader::GetNextHeader(EventHeader &h){
+    auto ev = GetNextEvent();
+    if(!ev)
+      return false;
+    ev->FillHeader(h);
+    return true;
+  }
+
+  uint64_t FileReader::SkipEvents(uint64_t n){
+    EventHeader h;
+    uint64_t i = 0;
+    while(i < n && GetNextHeader(h))
+      i++;
+    return i;
+  }
+
   FileReaderSP FileReader::Make(std::string type, std::string path){
       auto fw = eudaq::Factory<eudaq::FileReader>::MakeShared(eudaq::str2hash(type), path);
       if(!fw)
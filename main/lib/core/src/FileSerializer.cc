@@ -3,13 +3,203 @@
 #include "eudaq/Platform.hh"
 #include "eudaq/Utils.hh"
 #include "eudaq/Event.hh"
+#include "eudaq/Crc32c.hh"
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <iostream>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+
+#if EUDAQ_PLATFORM_IS(LINUX)
+#include <fcntl.h>
+#include <unistd.h>
+#include <limits.h>
+#include <sys/uio.h>
+#endif
 
 namespace eudaq {
-  FileSerializer::FileSerializer(const std::string &fname, bool overwrite)
-      : m_file(0), m_filebytes(0) {
+#if EUDAQ_PLATFORM_IS(LINUX)
+  // The data is copied into m_cur; full buffers are queued to m_full and
+  // the thread writes all queued ones with one pwritev. Buffers, their size
+  // and the file offsets are aligned for O_DIRECT; the last, partial buffer
+  // is written padded and the file truncated to its real size.
+  struct FileSerializer::DirectWriter {
+    DirectWriter(int fd, size_t buf_size);
+    ~DirectWriter();
+    void Write(const uint8_t *data, size_t len);
+    void Close();
+    void Submit();
+    void Writing();
+    std::string WriteBuffers(const std::vector<uint8_t *> &bufs, size_t len);
+
+    static const size_t ALIGN = 4096;
+    static const size_t N_BUF = 4;
+    int m_fd;
+    size_t m_buf_size;
+    uint64_t m_off;
+    uint64_t m_bytes;
+    std::vector<uint8_t *> m_bufs;
+    std::deque<uint8_t *> m_free;
+    std::deque<uint8_t *> m_full;
+    uint8_t *m_cur;
+    size_t m_cur_len;
+    std::thread m_th;
+    std::mutex m_mtx;
+    std::condition_variable m_cv;
+    bool m_exit;
+    std::string m_error;
+  };
+
+  FileSerializer::DirectWriter::DirectWriter(int fd, size_t buf_size)
+      : m_fd(fd), m_off(0), m_bytes(0), m_cur(nullptr), m_cur_len(0),
+        m_exit(false) {
+    m_buf_size = (std::max(buf_size, ALIGN) + ALIGN - 1) / ALIGN * ALIGN;
+    for (size_t i = 0; i < N_BUF; i++) {
+      void *p = nullptr;
+      if (posix_memalign(&p, ALIGN, m_buf_size) != 0)
+        EUDAQ_THROW("FileSerializer: unable to allocate the write buffers");
+      m_bufs.push_back(static_cast<uint8_t *>(p));
+      m_free.push_back(m_bufs.back());
+    }
+    m_cur = m_free.front();
+    m_free.pop_front();
+    m_th = std::thread(&DirectWriter::Writing, this);
+  }
+
+  FileSerializer::DirectWriter::~DirectWriter() {
+    {
+      std::lock_guard<std::mutex> lk(m_mtx);
+      m_exit = true;
+    }
+    m_cv.notify_all();
+    if (m_th.joinable())
+      m_th.join();
+    if (m_fd >= 0)
+      close(m_fd);
+    for (auto b : m_bufs)
+      free(b);
+  }
+
+  void FileSerializer::DirectWriter::Write(const uint8_t *data, size_t len) {
+    m_bytes += len;
+    while (len) {
+      size_t n = std::min(len, m_buf_size - m_cur_len);
+      memcpy(m_cur + m_cur_len, data, n);
+      m_cur_len += n;
+      data += n;
+      len -= n;
+      if (m_cur_len == m_buf_size)
+        Submit();
+    }
+  }
+
+  void FileSerializer::DirectWriter::Submit() {
+    std::unique_lock<std::mutex> lk(m_mtx);
+    m_full.push_back(m_cur);
+    m_cur = nullptr;
+    m_cv.notify_all();
+    m_cv.wait(lk, [this]() { return !m_free.empty() || !m_error.empty(); });
+    if (!m_error.empty())
+      EUDAQ_THROW("Error writing to file: " + m_error);
+    m_cur = m_free.front();
+    m_free.pop_front();
+    m_cur_len = 0;
+  }
+
+  void FileSerializer::DirectWriter::Writing() {
+    std::unique_lock<std::mutex> lk(m_mtx);
+    while (true) {
+      m_cv.wait(lk, [this]() { return !m_full.empty() || m_exit; });
+      if (m_full.empty())
+        break;
+      std::vector<uint8_t *> bufs(m_full.begin(), m_full.end());
+      m_full.clear();
+      bool failed = !m_error.empty();
+      lk.unlock();
+      std::string error;
+      if (!failed)
+        error = WriteBuffers(bufs, m_buf_size);
+      lk.lock();
+      for (auto b : bufs)
+        m_free.push_back(b);
+      if (!error.empty() && m_error.empty())
+        m_error = error;
+      m_cv.notify_all();
+    }
+  }
+
+  std::string FileSerializer::DirectWriter::WriteBuffers(
+      const std::vector<uint8_t *> &bufs, size_t len) {
+    std::vector<iovec> iov(bufs.size());
+    for (size_t i = 0; i < bufs.size(); i++) {
+      iov[i].iov_base = bufs[i];
+      iov[i].iov_len = len;
+    }
+    size_t i = 0;
+    while (i < iov.size()) {
+      int n = std::min<size_t>(iov.size() - i, IOV_MAX);
+      ssize_t w = pwritev(m_fd, &iov[i], n, m_off);
+      if (w < 0) {
+        if (errno == EINTR)
+          continue;
+        return to_string(errno) + ", " + strerror(errno);
+      }
+      m_off += w;
+      while (w > 0) {
+        if (size_t(w) >= iov[i].iov_len) {
+          w -= iov[i].iov_len;
+          i++;
+        } else {
+          iov[i].iov_base = static_cast<uint8_t *>(iov[i].iov_base) + w;
+          iov[i].iov_len -= w;
+          w = 0;
+        }
+      }
+    }
+    return "";
+  }
+
+  void FileSerializer::DirectWriter::Close() {
+    std::unique_lock<std::mutex> lk(m_mtx);
+    m_cv.wait(lk, [this]() {
+      return (m_full.empty() && m_free.size() + 1 == m_bufs.size()) ||
+             !m_error.empty();
+    });
+    if (!m_error.empty())
+      EUDAQ_THROW("Error writing to file: " + m_error);
+    lk.unlock();
+    if (m_cur_len) {
+      size_t padded = (m_cur_len + ALIGN - 1) / ALIGN * ALIGN;
+      memset(m_cur + m_cur_len, 0, padded - m_cur_len);
+      std::string error = WriteBuffers(std::vector<uint8_t *>(1, m_cur), padded);
+      if (!error.empty())
+        EUDAQ_THROW("Error writing to file: " + error);
+    }
+    if (ftruncate(m_fd, m_bytes) != 0)
+      EUDAQ_THROW("Error truncating file: " + to_string(errno) + ", " +
+                  strerror(errno));
+    int fd = m_fd;
+    m_fd = -1;
+    if (close(fd) != 0)
+      EUDAQ_THROW("Error closing file: " + to_string(errno) + ", " +
+                  strerror(errno));
+  }
+#else
+  struct FileSerializer::DirectWriter {
+    void Write(const uint8_t *, size_t) {}
+    void Close() {}
+  };
+#endif
+
+  FileSerializer::FileSerializer(const std::string &fname, bool overwrite,
+                                 const std::string &io, size_t buffer_size)
+      : m_file(0), m_filebytes(0), m_crc_on(false), m_crc(0) {
     if (!overwrite) {
       FILE *fd = fopen(fname.c_str(), "rb");
       if (fd) {
@@ -17,6 +207,23 @@ namespace eudaq {
         EUDAQ_THROWX(FileExistsException, "File already exists: " + fname);
       }
     }
+    if (io == "direct") {
+#if EUDAQ_PLATFORM_IS(LINUX)
+      int flags = O_WRONLY | O_CREAT | O_TRUNC;
+      int fd = open(fname.c_str(), flags | O_DIRECT, 0644);
+      // e.g. tmpfs has no O_DIRECT, the batched writes still help
+      if (fd < 0 && errno == EINVAL)
+        fd = open(fname.c_str(), flags, 0644);
+      if (fd < 0)
+        EUDAQ_THROWX(FileNotFoundException, "Unable to open file: " + fname);
+      m_direct.reset(new DirectWriter(fd, buffer_size));
+      return;
+#else
+      EUDAQ_WARN("FileSerializer: no direct io on this platform, using stdio");
+#endif
+    } else if (io != "stdio") {
+      EUDAQ_THROW("FileSerializer: unknown io <" + io + ">");
+    }
     m_file = fopen(fname.c_str(), "wb");
     if (!m_file)
       EUDAQ_THROWX(FileNotFoundException, "Unable to open file: " + fname);
@@ -26,9 +233,23 @@ namespace eudaq {
     if (m_file) {
       fclose(m_file);
     }
+    if (m_direct) {
+      try {
+        m_direct->Close();
+      } catch (const std::exception &e) {
+        EUDAQ_ERROR(std::string("FileSerializer: ") + e.what());
+      }
+    }
   }
 
   void FileSerializer::Serialize(const uint8_t *data, size_t len) {
+    if (m_crc_on)
+      m_crc = Crc32c(m_crc, data, len);
+    if (m_direct) {
+      m_direct->Write(data, len);
+      m_filebytes += len;
+      return;
+    }
     size_t written =
         std::fwrite(reinterpret_cast<const char *>(data), 1, len, m_file);
     m_filebytes += written;
@@ -38,5 +259,8 @@ namespace eudaq {
     }
   }
 
-  void FileSerializer::Flush() { fflush(m_file); }
+  void FileSerializer::Flush() {
+    if (m_file)
+      fflush(m_file);
+  }
 }
@@ -0,0 +1,172 @@
+#include "eudaq/LatencyTracer.hh"
+#include "eudaq/Exception.hh"
+#include "eudaq/Utils.hh"
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+
+namespace eudaq {
+
+  LatencyTracer &LatencyTracer::Instance(){
+    static LatencyTracer tracer;
+    return tracer;
+  }
+
+  uint64_t LatencyTracer::Now(){
+    return std::chrono::duration_cast<std::chrono::nanoseconds>
+      (std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  std::string LatencyTracer::Stage2String(uint32_t stage){
+    switch(stage){
+    case STAGE_PRODUCER_SEND: return "Producer::SendEvent";
+    case STAGE_RECEIVER_DECODE: return "DataReceiver::DataHandler";
+    case STAGE_COLLECTOR_WRITE: return "DataCollector::WriteEvent";
+    case STAGE_FILE_WRITE: return "FileWriter::WriteEvent";
+    case STAGE_MONITOR_RECEIVE: return "Monitor::OnReceive";
+    default: return "Unknown";
+    }
+  }
+
+  LatencyTracer::LatencyTracer()
+    :m_enabled(false), m_next_tid(0), m_dropped(0){
+    for(auto &h: m_hists)
+      h = Histogram{};
+  }
+
+  void LatencyTracer::SetEnabled(bool enable){
+    m_enabled = enable;
+  }
+
+  LatencyTracer::Ring &LatencyTracer::ThreadRing(){
+    thread_local RingHolder holder;
+    if(!holder.ring){
+      auto ring = std::make_shared<Ring>();
+      ring->head = 0;
+      ring->tail = 0;
+      ring->dropped = 0;
+      ring->exited = false;
+      std::unique_lock<std::mutex> lk(m_mtx_rings);
+      ring->tid = m_next_tid++;
+      m_rings.push_back(ring);
+      holder.ring = ring;
+    }
+    return *holder.ring;
+  }
+
+  void LatencyTracer::Trace(Stage stage, uint32_t ev_n, uint64_t t_begin, uint64_t t_end){
+    if(!IsEnabled())
+      return;
+    Ring &ring = ThreadRing();
+    uint64_t head = ring.head.load(std::memory_order_relaxed);
+    if(head - ring.tail.load(std::memory_order_acquire) >= RING_SIZE){
+      ring.dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    ring.buf[head & (RING_SIZE - 1)] = Record{t_begin, t_end, ev_n, static_cast<uint32_t>(stage)};
+    ring.head.store(head + 1, std::memory_order_release);
+  }
+
+  void LatencyTracer::Drain(){
+    std::unique_lock<std::mutex> lk_rings(m_mtx_rings);
+    auto rings = m_rings;
+    lk_rings.unlock();
+    for(auto &ring: rings){
+      uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+      uint64_t head = ring->head.load(std::memory_order_acquire);
+      for(; tail != head; tail++){
+	const Record &rec = ring->buf[tail & (RING_SIZE - 1)];
+	if(rec.stage < STAGE_N){
+	  uint64_t dt = rec.t_end > rec.t_begin ? rec.t_end - rec.t_begin : 0;
+	  size_t bin = 0;
+	  while((dt >> bin) > 1 && bin < HIST_BINS - 1)
+	    bin++;
+	  Histogram &h = m_hists[rec.stage];
+	  h.bins[bin]++;
+	  h.n++;
+	  h.sum_ns += dt;
+	  if(dt > h.max_ns)
+	    h.max_ns = dt;
+	}
+	m_records.push_back(std::make_pair(ring->tid, rec));
+	if(m_records.size() > KEEP_RECORDS)
+	  m_records.pop_front();
+      }
+      ring->tail.store(tail, std::memory_order_release);
+      m_dropped += ring->dropped.exchange(0, std::memory_order_relaxed);
+    }
+    lk_rings.lock();
+    for(auto it = m_rings.begin(); it != m_rings.end();){
+      Ring &ring = **it;
+      if(ring.exited && ring.tail.load() == ring.head.load())
+	it = m_rings.erase(it);
+      else
+	++it;
+    }
+  }
+
+  uint64_t LatencyTracer::Quantile(const Histogram &h, double q) const {
+    uint64_t target = static_cast<uint64_t>(q * h.n);
+    uint64_t acc = 0;
+    for(size_t i = 0; i < HIST_BINS; i++){
+      acc += h.bins[i];
+      if(acc > target)
+	return uint64_t(1) << (i + 1); // upper edge of the bucket
+    }
+    return h.max_ns;
+  }
+
+  std::map<std::string, std::string> LatencyTracer::GetSummary(){
+    std::map<std::string, std::string> tags;
+    std::unique_lock<std::mutex> lk(m_mtx_drain);
+    Drain();
+    for(uint32_t s = 0; s < STAGE_N; s++){
+      const Histogram &h = m_hists[s];
+      if(!h.n)
+	continue;
+      std::ostringstream os;
+      os << std::fixed << std::setprecision(1)
+	 << "n=" << h.n
+	 << " mean_us=" << h.sum_ns / 1e3 / h.n
+	 << " p50_us<" << Quantile(h, 0.5) / 1e3
+	 << " p99_us<" << Quantile(h, 0.99) / 1e3
+	 << " max_us=" << h.max_ns / 1e3;
+      tags["Trace." + Stage2String(s)] = os.str();
+    }
+    if(m_dropped)
+      tags["Trace.Dropped"] = std::to_string(m_dropped);
+    return tags;
+  }
+
+  void LatencyTracer::WriteChromeTrace(const std::string &path){
+    std::unique_lock<std::mutex> lk(m_mtx_drain);
+    Drain();
+    std::ofstream file(path);
+    if(!file.is_open())
+      EUDAQ_THROWX(FileWriteException, "LatencyTracer: Unable to open file: " + path);
+    file << "{\"traceEvents\":[";
+    bool first = true;
+    for(auto &tid_rec: m_records){
+      const Record &rec = tid_rec.second;
+      file << (first ? "\n" : ",\n");
+      first = false;
+      file << std::fixed << std::setprecision(3)
+	   << "{\"name\":\"" << Stage2String(rec.stage) << "\""
+	   << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << tid_rec.first
+	   << ",\"ts\":" << rec.t_begin / 1e3
+	   << ",\"dur\":" << (rec.t_end - rec.t_begin) / 1e3
+	   << ",\"args\":{\"EventN\":" << rec.ev_n << "}}";
+    }
+    file << "\n],\"displayTimeUnit\":\"ns\"}\n";
+  }
+
+  void LatencyTracer::Reset(){
+    std::unique_lock<std::mutex> lk(m_mtx_drain);
+    Drain();
+    for(auto &h: m_hists)
+      h = Histogram{};
+    m_records.clear();
+    m_dropped = 0;
+  }
+}
@@ -0,0 +1,191 @@
+#include "eudaq/Metrics.hh"
+#include "eudaq/Exception.hh"
+#include "eudaq/Utils.hh"
+
+#include <chrono>
+#include <cctype>
+#include <cstring>
+
+#if !EUDAQ_PLATFORM_IS(WIN32)
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+#include <unistd.h>
+#endif
+
+namespace eudaq {
+
+  namespace{
+    double SteadySeconds(){
+      return std::chrono::duration<double>
+	(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    std::string PrometheusName(const std::string &name){
+      std::string pname = "eudaq_";
+      for(auto c: name)
+	pname += std::isalnum(static_cast<unsigned char>(c)) ? std::tolower(c) : '_';
+      return pname;
+    }
+  }
+
+  MetricRegistry::MetricRegistry(double window_s)
+    :m_window(window_s){
+  }
+
+  MetricCounter &MetricRegistry::Counter(const std::string &name, const std::string &unit){
+    std::unique_lock<std::mutex> lk(m_mtx);
+    auto &c = m_counters[name];
+    if(!c)
+      c.reset(new MetricCounter(unit));
+    return *c;
+  }
+
+  MetricGauge &MetricRegistry::Gauge(const std::string &name){
+    std::unique_lock<std::mutex> lk(m_mtx);
+    auto &g = m_gauges[name];
+    if(!g)
+      g.reset(new MetricGauge);
+    return *g;
+  }
+
+  void MetricRegistry::SetWindow(double window_s){
+    std::unique_lock<std::mutex> lk(m_mtx);
+    m_window = window_s;
+  }
+
+  void MetricRegistry::Reset(){
+    std::unique_lock<std::mutex> lk(m_mtx);
+    for(auto &c: m_counters)
+      c.second->Reset();
+    for(auto &g: m_gauges)
+      g.second->Reset();
+    m_samples.clear();
+  }
+
+  double MetricRegistry::Rate(const std::string &name, const MetricCounter &c, double now){
+    auto &samples = m_samples[name];
+    uint64_t v = c.Get();
+    if(samples.empty() || now > samples.back().t)
+      samples.push_back(Sample{now, v});
+    while(samples.size() > 2 && now - samples[1].t >= m_window)
+      samples.pop_front();
+    const Sample &first = samples.front();
+    if(now <= first.t || v < first.v)
+      return 0;
+    return (v - first.v) / (now - first.t);
+  }
+
+  std::map<std::string, std::string> MetricRegistry::GetStatusTags(){
+    std::map<std::string, std::string> tags;
+    std::unique_lock<std::mutex> lk(m_mtx);
+    double now = SteadySeconds();
+    for(auto &e: m_counters){
+      auto &c = *e.second;
+      double rate = Rate(e.first, c, now);
+      std::ostringstream os;
+      os << std::fixed << std::setprecision(2);
+      if(c.Unit() == "B")
+	os << rate / 1e6 << " MB/s";
+      else
+	os << rate << " Hz";
+      tags[e.first] = std::to_string(c.Get());
+      tags[e.first + "Rate"] = os.str();
+    }
+    for(auto &e: m_gauges)
+      tags[e.first] = std::to_string(e.second->Get());
+    return tags;
+  }
+
+  std::string MetricRegistry::GetPrometheusText(const std::string &labels){
+    std::ostringstream os;
+    std::string lb = labels.empty() ? "" : "{" + labels + "}";
+    std::unique_lock<std::mutex> lk(m_mtx);
+    double now = SteadySeconds();
+    for(auto &e: m_counters){
+      std::string pname = PrometheusName(e.first);
+      os << "# TYPE " << pname << "_total counter\n"
+	 << pname << "_total" << lb << " " << e.second->Get() << "\n"
+	 << "# TYPE " << pname << "_rate gauge\n"
+	 << pname << "_rate" << lb << " " << Rate(e.first, *e.second, now) << "\n";
+    }
+    for(auto &e: m_gauges){
+      std::string pname = PrometheusName(e.first);
+      os << "# TYPE " << pname << " gauge\n"
+	 << pname << lb << " " << e.second->Get() << "\n";
+    }
+    return os.str();
+  }
+
+#if EUDAQ_PLATFORM_IS(WIN32)
+  MetricsEndpoint::MetricsEndpoint(uint16_t port, std::function<std::string()> text)
+    :m_text(text), m_fd(-1), m_go_stop(false){
+    EUDAQ_THROW("MetricsEndpoint: not supported on this platform");
+  }
+
+  MetricsEndpoint::~MetricsEndpoint(){
+  }
+
+  void MetricsEndpoint::Serving(){
+  }
+#else
+  MetricsEndpoint::MetricsEndpoint(uint16_t port, std::function<std::string()> text)
+    :m_text(text), m_fd(-1), m_go_stop(false){
+    m_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if(m_fd < 0)
+      EUDAQ_THROW("MetricsEndpoint: unable to create socket");
+    int yes = 1;
+    setsockopt(m_fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if(bind(m_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0
+       || listen(m_fd, 4) != 0){
+      close(m_fd);
+      EUDAQ_THROW("MetricsEndpoint: unable to listen on port " + std::to_string(port));
+    }
+    m_th = std::thread(&MetricsEndpoint::Serving, this);
+  }
+
+  MetricsEndpoint::~MetricsEndpoint(){
+    m_go_stop = true;
+    if(m_th.joinable())
+      m_th.join();
+    if(m_fd >= 0)
+      close(m_fd);
+  }
+
+  void MetricsEndpoint::Serving(){
+    while(!m_go_stop){
+      fd_set fds;
+      FD_ZERO(&fds);
+      FD_SET(m_fd, &fds);
+      timeval tv = {0, 200000};
+      if(select(m_fd + 1, &fds, nullptr, nullptr, &tv) <= 0)
+	continue;
+      int con = accept(m_fd, nullptr, nullptr);
+      if(con < 0)
+	continue;
+      char req[1024];
+      timeval tv_rcv = {1, 0};
+      setsockopt(con, SOL_SOCKET, SO_RCVTIMEO, &tv_rcv, sizeof(tv_rcv));
+      recv(con, req, sizeof(req), 0); // the request itself is not looked at
+      std::string body = m_text();
+      std::string rsp = "HTTP/1.0 200 OK\r\n"
+	"Content-Type: text/plain; version=0.0.4\r\n"
+	"Content-Length: " + std::to_string(body.size()) + "\r\n"
+	"Connection: close\r\n\r\n" + body;
+      size_t sent = 0;
+      while(sent < rsp.size()){
+	ssize_t n = send(con, rsp.data() + sent, rsp.size() - sent, 0);
+	if(n <= 0)
+	  break;
+	sent += n;
+      }
+      close(con);
+    }
+  }
+#endif
+}
@@ -1,5 +1,6 @@
 #include "eudaq/Monitor.hh"
 #include "eudaq/Logger.hh"
+#include "eudaq/LatencyTracer.hh"
 #include "eudaq/TransportServer.hh"
 #include "eudaq/BufferSerializer.hh"
 #include "eudaq/Logger.hh"
@@ -8,6 +9,7 @@
 #include <ostream>
 #include <ctime>
 #include <iomanip>
+#include <algorithm>
 namespace eudaq {
   template class DLLEXPORT Factory<Monitor>;
   template DLLEXPORT std::map<uint32_t, typename Factory<Monitor>::UP_BASE (*)
@@ -15,7 +17,10 @@ namespace eudaq {
   Factory<Monitor>::Instance<const std::string&, const std::string&>(); //TODO
   
   Monitor::Monitor(const std::string &name, const std::string &runcontrol)
-    :m_evt_c(0),CommandReceiver("Monitor", name, runcontrol){
+    :m_evt_c(0),CommandReceiver("Monitor", name, runcontrol),
+     m_mtr_evt(GetMetrics().Counter("Events")),
+     m_target_load(0), m_fraction(1), m_credit(0), m_busy_ns(0), m_win_rec_c(0),
+     m_rec_c(0), m_acc_c(0), m_drop_c(0){
   }
 
   void Monitor::DoInitialise(){
@@ -45,6 +50,57 @@ namespace eudaq {
   void Monitor::SetServerAddress(const std::string &addr){
     m_data_addr = addr;
   }
+
+  // Fraction of the wall time the analysis may use, e.g. 0.8. Above that the
+  // monitor only looks at a part of the events. 0 disables the prescale.
+  void Monitor::SetTargetLoad(double load){
+    m_target_load = std::max(0., load);
+  }
+
+  // analysed/received events of the current run, to normalise histograms
+  double Monitor::GetSampleFraction() const {
+    uint64_t rec = m_rec_c.load();
+    uint64_t acc = m_acc_c.load();
+    uint64_t drop = std::min(m_drop_c.load(), acc);
+    return rec ? double(acc - drop) / rec : 1.;
+  }
+
+  void Monitor::AddBusyTime(double sec){
+    m_busy_ns += uint64_t(sec * 1e9);
+  }
+
+  void Monitor::CountDropped(){
+    m_drop_c ++;
+  }
+
+  bool Monitor::Sample(){
+    m_rec_c ++;
+    m_win_rec_c ++;
+    if(m_target_load <= 0)
+      return true;
+    m_credit += m_fraction;
+    if(m_credit < 1)
+      return false;
+    m_credit -= 1;
+    return true;
+  }
+
+  void Monitor::UpdateSampling(){
+    auto now = std::chrono::steady_clock::now();
+    double elapsed = std::chrono::duration<double>(now - m_win_start).count();
+    if(elapsed < 0.5)
+      return;
+    double load = m_busy_ns.exchange(0) * 1e-9 / elapsed;
+    if(m_target_load > 0){
+      double fraction = load > 0 ? m_fraction * m_target_load / load : 1;
+      // follow a rising load at once, but recover at most 2x per window
+      fraction = std::min(fraction, m_fraction * 2);
+      m_fraction = std::min(1., std::max(1e-4, fraction));
+    }
+    GetMetrics().Gauge("ReceiveRate").Set(int64_t(m_win_rec_c / elapsed));
+    m_win_start = now;
+    m_win_rec_c = 0;
+  }
   
   void Monitor::OnInitialise(){
     EUDAQ_INFO(GetFullName() + " is to be initialised...");
@@ -68,6 +124,8 @@ namespace eudaq {
     auto conf = GetConfiguration();
     try {
       SetStatus(Status::STATE_UNCONF, "Configuring");
+      if(conf)
+	SetTargetLoad(conf->Get("EUDAQ_MON_TARGET_LOAD", m_target_load));
       DoConfigure();
       CommandReceiver::OnConfigure();
     }catch (const Exception &e) {
@@ -83,6 +141,14 @@ namespace eudaq {
       m_data_addr = Listen(m_data_addr);
       SetStatusTag("_SERVER", m_data_addr);
       m_evt_c = 0;
+      m_fraction = 1;
+      m_credit = 0;
+      m_busy_ns = 0;
+      m_win_rec_c = 0;
+      m_win_start = std::chrono::steady_clock::now();
+      m_rec_c = 0;
+      m_acc_c = 0;
+      m_drop_c = 0;
       DoStartRun();
       CommandReceiver::OnStartRun();
     } catch (const Exception &e) {
@@ -128,13 +194,28 @@ namespace eudaq {
     
   void Monitor::OnStatus(){
     SetStatusTag("EventN", std::to_string(m_evt_c));
+    if(m_target_load > 0)
+      SetStatusTag("SampleFraction", std::to_string(GetSampleFraction()));
+    GetMetrics().Gauge("ReceiveQueue").Set(GetQueueSize());
+    GetMetrics().Gauge("ReceiveDropped").Set(GetDropCount());
     DoStatus();
     CommandReceiver::OnStatus();
   }
 
   void Monitor::OnReceive(ConnectionSPC id, EventSP ev){
+    LatencyTraceScope trace(LatencyTracer::STAGE_MONITOR_RECEIVE, ev->GetEventN());
     m_evt_c ++;
+    m_mtr_evt.Add();
+    // the begin and end of run events are always passed on
+    if(!Sample() && !ev->IsBORE() && !ev->IsEORE()){
+      UpdateSampling();
+      return;
+    }
+    m_acc_c ++;
+    auto tp_start = std::chrono::steady_clock::now();
     DoReceive(ev);
+    AddBusyTime(std::chrono::duration<double>(std::chrono::steady_clock::now() - tp_start).count());
+    UpdateSampling();
   }
   
   MonitorSP Monitor::Make(const std::string &code_name,
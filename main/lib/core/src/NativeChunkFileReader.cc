@@ -0,0 +1,237 @@
+#include "eudaq/FileReader.hh"
+#include "eudaq/FileDeserializer.hh"
+#include "eudaq/NativeFileIndex.hh"
+#include "eudaq/Exception.hh"
+#include "eudaq/Logger.hh"
+#include "eudaq/Utils.hh"
+
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <atomic>
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <cstdio>
+
+// Reads the chunks of a run written with EUDAQ_FW_CHUNK_EVENTS or
+// EUDAQ_FW_CHUNK_MB. The path is the first chunk to read, e.g.
+// run000123_0000.raw, followed by the chunks numbered after it, or a comma
+// separated list of chunks. The footers order the chunks by event number
+// and let skipped events be passed over without reading them. READ_CHUNKS
+// chunks are read at once, each on its own thread.
+class NativeChunkFileReader : public eudaq::FileReader {
+public:
+  NativeChunkFileReader(const std::string& path);
+  ~NativeChunkFileReader() override;
+  eudaq::EventSPC GetNextEvent() override;
+  uint64_t SkipEvents(uint64_t n) override;
+  static const uint32_t m_id_factory = eudaq::cstr2hash("nativechunk");
+
+private:
+  struct Chunk {
+    std::string path;
+    bool has_index = false;
+    eudaq::NativeFileIndex index;
+    uint64_t skip = 0;
+    std::unique_ptr<eudaq::FileDeserializer> des;
+    std::thread th;
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::deque<eudaq::EventSPC> que;
+    bool done = false;
+    std::exception_ptr err;
+  };
+  void Plan();
+  void Launch();
+  void Reading(Chunk *ck);
+
+  std::vector<std::unique_ptr<Chunk>> m_chunks;
+  size_t m_cur;
+  size_t m_launched;
+  bool m_planned;
+  size_t m_parallel;
+  size_t m_read_ahead;
+  std::atomic_bool m_exit;
+};
+
+namespace{
+  auto dummy0 = eudaq::Factory<eudaq::FileReader>::
+    Register<NativeChunkFileReader, std::string&>(NativeChunkFileReader::m_id_factory);
+  auto dummy1 = eudaq::Factory<eudaq::FileReader>::
+    Register<NativeChunkFileReader, std::string&&>(NativeChunkFileReader::m_id_factory);
+
+  bool FileExists(const std::string &path){
+    FILE *fd = fopen(path.c_str(), "rb");
+    if(!fd)
+      return false;
+    fclose(fd);
+    return true;
+  }
+}
+
+NativeChunkFileReader::NativeChunkFileReader(const std::string& path)
+  :m_cur(0), m_launched(0), m_planned(false), m_parallel(4), m_read_ahead(1024), m_exit(false){
+  std::vector<std::string> paths = eudaq::split(path, ",", true);
+  if(paths.size() == 1){
+    // <stem>_NNNN<ext>: the chunks numbered from NNNN on
+    std::string p = paths[0];
+    size_t dot = p.find_last_of(".");
+    size_t us = p.find_last_of("_", dot);
+    std::string num = (us == std::string::npos || dot == std::string::npos) ?"" :p.substr(us+1, dot-us-1);
+    if(!num.empty() && num.find_first_not_of("0123456789") == std::string::npos){
+      paths.clear();
+      for(uint32_t n = std::stoul(num); ; n++){
+	std::ostringstream os;
+	os<<p.substr(0, us+1)<<std::setw(num.size())<<std::setfill('0')<<n<<p.substr(dot);
+	if(!FileExists(os.str()))
+	  break;
+	paths.push_back(os.str());
+      }
+      if(paths.empty())
+	EUDAQ_THROW("NativeChunkFileReader: no chunk " + p);
+    }
+  }
+  for(auto &p: paths){
+    m_chunks.emplace_back(new Chunk);
+    m_chunks.back()->path = p;
+  }
+  if(m_chunks.empty())
+    EUDAQ_THROW("NativeChunkFileReader: no input file in <" + path + ">");
+}
+
+NativeChunkFileReader::~NativeChunkFileReader(){
+  m_exit = true;
+  for(auto &ck: m_chunks){
+    std::unique_lock<std::mutex> lk(ck->mtx);
+    // wakes a reader waiting for a chunk that is still being written
+    if(ck->des)
+      ck->des->Interrupt();
+    lk.unlock();
+    ck->cv.notify_all();
+  }
+  for(auto &ck: m_chunks)
+    if(ck->th.joinable())
+      ck->th.join();
+}
+
+void NativeChunkFileReader::Plan(){
+  auto conf = GetConfiguration();
+  if(conf){
+    m_parallel = conf->Get("READ_CHUNKS", m_parallel);
+    m_read_ahead = conf->Get("READ_AHEAD", m_read_ahead);
+  }
+  if(!m_parallel)
+    m_parallel = 1;
+  if(!m_read_ahead)
+    m_read_ahead = 1;
+  bool all_index = true;
+  for(auto &ck: m_chunks){
+    try{
+      ck->has_index = eudaq::NativeFileIndex::ReadFooter(ck->path, ck->index);
+    }
+    catch(const std::exception &e){
+      EUDAQ_WARN("NativeChunkFileReader: " + ck->path + ": " + e.what());
+    }
+    if(!ck->has_index)
+      all_index = false;
+  }
+  // without every footer the given order is kept
+  if(all_index)
+    std::stable_sort(m_chunks.begin(), m_chunks.end(),
+		     [](const std::unique_ptr<Chunk> &a, const std::unique_ptr<Chunk> &b){
+		       return a->index.m_ev_first < b->index.m_ev_first;});
+  m_planned = true;
+}
+
+void NativeChunkFileReader::Launch(){
+  while(m_launched < m_chunks.size() && m_launched < m_cur + m_parallel){
+    Chunk *ck = m_chunks[m_launched].get();
+    ck->th = std::thread(&NativeChunkFileReader::Reading, this, ck);
+    m_launched++;
+  }
+}
+
+void NativeChunkFileReader::Reading(Chunk *ck){
+  try{
+    std::unique_ptr<eudaq::FileDeserializer> pdes(new eudaq::FileDeserializer(ck->path));
+    {
+      std::unique_lock<std::mutex> lk(ck->mtx);
+      ck->des = std::move(pdes);
+    }
+    eudaq::FileDeserializer &des = *ck->des;
+    if(m_exit)
+      throw eudaq::InterruptedException();
+    if(ck->skip && ck->has_index && ck->skip < ck->index.NumEvents())
+      des.Seek(ck->index.m_offsets[ck->skip]);
+    else
+      for(uint64_t i = 0; i < ck->skip && des.SkipEvent(); i++);
+    while(1){
+      eudaq::EventSPC ev = des.ReadEvent();
+      std::unique_lock<std::mutex> lk(ck->mtx);
+      if(!ev || m_exit)
+	break;
+      ck->cv.wait(lk, [&](){return m_exit || ck->que.size() < m_read_ahead;});
+      ck->que.push_back(ev);
+      lk.unlock();
+      ck->cv.notify_all();
+    }
+  }
+  catch(...){
+    std::unique_lock<std::mutex> lk(ck->mtx);
+    ck->err = std::current_exception();
+  }
+  std::unique_lock<std::mutex> lk(ck->mtx);
+  ck->done = true;
+  lk.unlock();
+  ck->cv.notify_all();
+}
+
+eudaq::EventSPC NativeChunkFileReader::GetNextEvent(){
+  if(!m_planned)
+    Plan();
+  Launch();
+  while(m_cur < m_chunks.size()){
+    Chunk &ck = *m_chunks[m_cur];
+    std::unique_lock<std::mutex> lk(ck.mtx);
+    ck.cv.wait(lk, [&](){return ck.done || !ck.que.empty();});
+    if(!ck.que.empty()){
+      auto ev = std::move(ck.que.front());
+      ck.que.pop_front();
+      lk.unlock();
+      ck.cv.notify_all();
+      return ev;
+    }
+    lk.unlock();
+    ck.th.join();
+    if(ck.err)
+      std::rethrow_exception(ck.err);
+    m_cur++;
+    Launch();
+  }
+  return nullptr;
+}
+
+uint64_t NativeChunkFileReader::SkipEvents(uint64_t n){
+  if(!m_planned)
+    Plan();
+  // once reading has started the events come from the threads
+  if(m_launched > m_cur)
+    return FileReader::SkipEvents(n);
+  uint64_t skipped = 0;
+  while(m_cur < m_chunks.size() && m_chunks[m_cur]->has_index){
+    Chunk &ck = *m_chunks[m_cur];
+    // a skip may already be pending on this chunk
+    uint64_t n_left = ck.index.NumEvents() - std::min(ck.skip, ck.index.NumEvents());
+    if(n - skipped < n_left){
+      ck.skip += n - skipped;
+      return n;
+    }
+    skipped += n_left;
+    m_cur++;
+    m_launched = m_cur;
+  }
+  return skipped + FileReader::SkipEvents(n - skipped);
+}
@@ -0,0 +1,124 @@
+#include "eudaq/NativeFileIndex.hh"
+#include "eudaq/FileDeserializer.hh"
+#include "eudaq/BufferSerializer.hh"
+#include "eudaq/Crc32c.hh"
+#include "eudaq/Exception.hh"
+
+namespace eudaq {
+
+  NativeFileIndex::NativeFileIndex(){
+    Clear();
+  }
+
+  NativeFileIndex::NativeFileIndex(Deserializer &ds){
+    ds.read(m_offsets);
+    ds.read(m_ev_first);
+    ds.read(m_ev_last);
+    ds.read(m_has_tg);
+    ds.read(m_tg_min);
+    ds.read(m_tg_max);
+    ds.read(m_has_ts);
+    ds.read(m_ts_min);
+    ds.read(m_ts_max);
+    ds.read(m_streams);
+  }
+
+  void NativeFileIndex::Serialize(Serializer &ser) const {
+    ser.write(m_offsets);
+    ser.write(m_ev_first);
+    ser.write(m_ev_last);
+    ser.write(m_has_tg);
+    ser.write(m_tg_min);
+    ser.write(m_tg_max);
+    ser.write(m_has_ts);
+    ser.write(m_ts_min);
+    ser.write(m_ts_max);
+    ser.write(m_streams);
+  }
+
+  void NativeFileIndex::Clear(){
+    m_offsets.clear();
+    m_ev_first = 0;
+    m_ev_last = 0;
+    m_has_tg = false;
+    m_tg_min = 0;
+    m_tg_max = 0;
+    m_has_ts = false;
+    m_ts_min = 0;
+    m_ts_max = 0;
+    m_streams.clear();
+  }
+
+  void NativeFileIndex::Add(const Event &ev, uint64_t offset){
+    if(m_offsets.empty())
+      m_ev_first = ev.GetEventN();
+    m_ev_last = ev.GetEventN();
+    m_offsets.push_back(offset);
+    AddStreams(ev);
+  }
+
+  void NativeFileIndex::AddStreams(const Event &ev){
+    if(ev.IsFlagTrigger()){
+      uint32_t tg = ev.GetTriggerN();
+      if(!m_has_tg || tg < m_tg_min)
+	m_tg_min = tg;
+      if(!m_has_tg || tg > m_tg_max)
+	m_tg_max = tg;
+      m_has_tg = true;
+    }
+    if(ev.IsFlagTimestamp()){
+      if(!m_has_ts || ev.GetTimestampBegin() < m_ts_min)
+	m_ts_min = ev.GetTimestampBegin();
+      if(!m_has_ts || ev.GetTimestampEnd() > m_ts_max)
+	m_ts_max = ev.GetTimestampEnd();
+      m_has_ts = true;
+    }
+    uint32_t n_sub = ev.GetNumSubEvent();
+    // a packet is counted through its sub-events
+    if(!n_sub)
+      m_streams[ev.GetDescription()][ev.GetStreamN()]++;
+    for(uint32_t i = 0; i < n_sub; i++)
+      AddStreams(*ev.GetSubEvent(i));
+  }
+
+  bool NativeFileIndex::ReadFooter(const std::string &path, NativeFileIndex &idx){
+    FileDeserializer des(path, true);
+    uint64_t size = des.FileSize();
+    uint64_t trailer = des.FormatVersion() >= 2 ?16 :12;
+    if(!des.IsFramed() || size < 8 + trailer)
+      return false;
+    des.Seek(size - trailer);
+    uint64_t offset;
+    uint32_t magic;
+    des.read(offset);
+    des.read(magic);
+    if(magic != NATIVE_FOOTER_MAGIC || offset >= size - trailer)
+      return false;
+    des.Seek(offset);
+    if(trailer == 12){
+      uint64_t len;
+      uint32_t id;
+      des.read(len);
+      des.read(id);
+      if(id != NATIVE_FOOTER_ID)
+	EUDAQ_THROWX(FileReadException, "Broken footer in " + path);
+      idx = NativeFileIndex(des);
+      return true;
+    }
+    // the offsets are only used once the checksum of the frame matches
+    std::vector<uint8_t> frame;
+    if(!des.ReadFrame(frame) || frame.size() < 8)
+      EUDAQ_THROWX(FileReadException, "Broken footer in " + path);
+    size_t n = frame.size() - 4;
+    uint32_t crc = frame[n] | (frame[n+1] << 8) | (frame[n+2] << 16) | (uint32_t(frame[n+3]) << 24);
+    if(Crc32c(0, frame.data(), n) != crc)
+      EUDAQ_THROWX(FileReadException, "Bad checksum of the footer in " + path);
+    BufferSerializer bs(frame.begin(), frame.begin() + n);
+    uint32_t id;
+    bs.read(id);
+    if(id != NATIVE_FOOTER_ID)
+      EUDAQ_THROWX(FileReadException, "Broken footer in " + path);
+    idx = NativeFileIndex(bs);
+    return true;
+  }
+}
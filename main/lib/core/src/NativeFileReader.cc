@@ -5,6 +5,8 @@ class NativeFileReader : public eudaq::FileReader {
 public:
   NativeFileReader(const std::string& filename);
   eudaq::EventSPC GetNextEvent()override;
+  bool GetNextHeader(eudaq::EventHeader &h)override;
+  uint64_t SkipEvents(uint64_t n)override;
 private:
   std::unique_ptr<eudaq::FileDeserializer> m_des;
   std::string m_filename;
@@ -27,14 +29,20 @@ eudaq::EventSPC NativeFileReader::GetNextEvent(){
     if(!m_des)
       EUDAQ_THROW("unable to open file: " + m_filename);
   }
-  eudaq::EventUP ev;
-  uint32_t id;
-  
-  if(m_des->HasData()){
-    m_des->PreRead(id);
-    ev = eudaq::Factory<eudaq::Event>::
-      Create<eudaq::Deserializer&>(id, *m_des);
-    return std::move(ev);
-  }  else  return nullptr;
-  
+  return m_des->ReadEvent();
+}
+
+bool NativeFileReader::GetNextHeader(eudaq::EventHeader &h){
+  if(!m_des)
+    m_des.reset(new eudaq::FileDeserializer(m_filename));
+  return m_des->ReadHeader(h);
+}
+
+uint64_t NativeFileReader::SkipEvents(uint64_t n){
+  if(!m_des)
+    m_des.reset(new eudaq::FileDeserializer(m_filename));
+  uint64_t i = 0;
+  while(i < n && m_des->SkipEvent())
+    i++;
+  return i;
 }
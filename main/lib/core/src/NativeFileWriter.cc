@@ -1,16 +1,38 @@
 #include "eudaq/FileNamer.hh"
 #include "eudaq/FileWriter.hh"
 #include "eudaq/FileSerializer.hh"
+#include "eudaq/NativeFileIndex.hh"
+#include "eudaq/LatencyTracer.hh"
+#include "eudaq/Logger.hh"
 
+#include <iomanip>
+#include <sstream>
+
+// Writes the events of a run to a .raw file, or with EUDAQ_FW_CHUNK_EVENTS
+// or EUDAQ_FW_CHUNK_MB set, to chunks $X = _0000.raw, _0001.raw, ... of
+// at most that many events or MB. Every file ends with a NativeFileIndex.
+// EUDAQ_FW_IO=direct selects the direct io of FileSerializer, with buffers
+// of EUDAQ_FW_IO_BUFFER_MB.
 class NativeFileWriter : public eudaq::FileWriter {
 public:
   NativeFileWriter(const std::string &patt);
+  ~NativeFileWriter() override;
   void WriteEvent(eudaq::EventSPC ev) override;
   uint64_t FileBytes() const override;
 private:
+  void OpenChunk();
+  void CloseChunk();
   std::unique_ptr<eudaq::FileSerializer> m_ser;
   std::string m_filepattern;
   uint32_t m_run_n;
+  std::string m_time_str;
+  uint64_t m_chunk_events;
+  uint64_t m_chunk_bytes;
+  uint32_t m_chunk_n;
+  uint64_t m_closed_bytes;
+  std::string m_io;
+  size_t m_io_buffer;
+  eudaq::NativeFileIndex m_index;
 };
 
 namespace{
@@ -20,31 +42,99 @@ namespace{
     Register<NativeFileWriter, std::string&&>(eudaq::cstr2hash("native"));
 }
 
-NativeFileWriter::NativeFileWriter(const std::string &patt){
+NativeFileWriter::NativeFileWriter(const std::string &patt)
+  :m_run_n(0), m_chunk_events(0), m_chunk_bytes(0), m_chunk_n(0),
+   m_closed_bytes(0), m_io("stdio"), m_io_buffer(4 << 20){
   m_filepattern = patt;
 }
-  
+
+NativeFileWriter::~NativeFileWriter(){
+  try{
+    CloseChunk();
+  }
+  catch(const std::exception &e){
+    EUDAQ_ERROR(std::string("NativeFileWriter: ") + e.what());
+  }
+}
+
 void NativeFileWriter::WriteEvent(eudaq::EventSPC ev) {
+  eudaq::LatencyTraceScope trace(eudaq::LatencyTracer::STAGE_FILE_WRITE, ev->GetEventN());
   uint32_t run_n = ev->GetRunN();
   if(!m_ser || m_run_n != run_n){
+    CloseChunk();
     std::time_t time_now = std::time(nullptr);
     char time_buff[13];
     time_buff[12] = 0;
     std::strftime(time_buff, sizeof(time_buff),
 		  "%y%m%d%H%M%S", std::localtime(&time_now));
-    std::string time_str(time_buff);
-    m_ser.reset(new eudaq::FileSerializer((eudaq::FileNamer(m_filepattern).
-					   Set('X', ".raw").
-					   Set('R', run_n).
-					   Set('D', time_str))));
+    m_time_str = time_buff;
     m_run_n = run_n;
+    m_chunk_n = 0;
+    m_closed_bytes = 0;
+    auto conf = GetConfiguration();
+    if(conf){
+      m_chunk_events = conf->Get("EUDAQ_FW_CHUNK_EVENTS", 0);
+      m_chunk_bytes = uint64_t(conf->Get("EUDAQ_FW_CHUNK_MB", 0)) << 20;
+      m_io = conf->Get("EUDAQ_FW_IO", m_io);
+      m_io_buffer = size_t(conf->Get("EUDAQ_FW_IO_BUFFER_MB", 4)) << 20;
+    }
+    OpenChunk();
+  }
+  else if((m_chunk_events && m_index.NumEvents() >= m_chunk_events) ||
+	  (m_chunk_bytes && m_ser->FileBytes() >= m_chunk_bytes)){
+    CloseChunk();
+    m_chunk_n++;
+    OpenChunk();
   }
   if(!m_ser)
     EUDAQ_THROW("NativeFileWriter: Attempt to write unopened file");
+  m_index.Add(*ev, m_ser->FileBytes());
+  eudaq::CountingSerializer count;
+  count.write(*ev);
+  m_ser->write(count.Bytes() + sizeof(uint32_t));
+  m_ser->ResetCheckSum();
   m_ser->write(*(ev.get())); //TODO: Serializer accepts EventSPC
+  m_ser->write(uint32_t(m_ser->GetCheckSum()));
   m_ser->Flush();
 }
-  
+
+void NativeFileWriter::OpenChunk(){
+  std::string suffix = ".raw";
+  if(m_chunk_events || m_chunk_bytes){
+    std::ostringstream os;
+    os<<"_"<<std::setw(4)<<std::setfill('0')<<m_chunk_n<<".raw";
+    suffix = os.str();
+  }
+  m_ser.reset(new eudaq::FileSerializer((eudaq::FileNamer(m_filepattern).
+					 Set('X', suffix).
+					 Set('R', m_run_n).
+					 Set('D', m_time_str)), false, m_io, m_io_buffer));
+  m_ser->write(eudaq::NATIVE_FILE_MAGIC);
+  m_ser->write(eudaq::NATIVE_FILE_VERSION);
+  m_index.Clear();
+}
+
+void NativeFileWriter::CloseChunk(){
+  if(!m_ser)
+    return;
+  uint64_t offset = m_ser->FileBytes();
+  eudaq::CountingSerializer count;
+  count.write(eudaq::NATIVE_FOOTER_ID);
+  count.write(m_index);
+  count.write(offset);
+  count.write(eudaq::NATIVE_FOOTER_MAGIC);
+  m_ser->write(count.Bytes() + sizeof(uint32_t));
+  m_ser->ResetCheckSum();
+  m_ser->write(eudaq::NATIVE_FOOTER_ID);
+  m_ser->write(m_index);
+  m_ser->write(offset);
+  m_ser->write(eudaq::NATIVE_FOOTER_MAGIC);
+  m_ser->write(uint32_t(m_ser->GetCheckSum()));
+  m_closed_bytes += m_ser->FileBytes();
+  m_ser.reset();
+}
+
 uint64_t NativeFileWriter::FileBytes() const {
-  return m_ser ?m_ser->FileBytes() :0;
+  // all the chunks of the run, not only the open one
+  return m_closed_bytes + (m_ser ?m_ser->FileBytes() :0);
 }
@@ -0,0 +1,181 @@
+#include "eudaq/FileReader.hh"
+#include "eudaq/Exception.hh"
+#include "eudaq/Utils.hh"
+
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <atomic>
+
+// Reads several files at once, each one on its own thread, and merges them
+// into packet events (FLAG_PACK) ordered by trigger number or timestamp.
+// The path is the comma separated list of the input files.
+class NativeMergeFileReader : public eudaq::FileReader {
+public:
+  NativeMergeFileReader(const std::string& filenames);
+  ~NativeMergeFileReader() override;
+  eudaq::EventSPC GetNextEvent() override;
+  static const uint32_t m_id_factory = eudaq::cstr2hash("nativemerge");
+
+private:
+  struct Stream {
+    std::string path;
+    std::thread th;
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::deque<eudaq::EventSPC> que;
+    bool done = false;
+    std::exception_ptr err;
+    eudaq::EventSPC head;
+  };
+  void Start();
+  void Reading(Stream *st);
+  eudaq::EventSPC Pop(Stream &st);
+
+  std::vector<std::unique_ptr<Stream>> m_streams;
+  bool m_started;
+  bool m_by_ts;
+  size_t m_read_ahead;
+  std::atomic_bool m_exit;
+  uint32_t m_ev_n;
+};
+
+namespace{
+  auto dummy0 = eudaq::Factory<eudaq::FileReader>::
+    Register<NativeMergeFileReader, std::string&>(NativeMergeFileReader::m_id_factory);
+  auto dummy1 = eudaq::Factory<eudaq::FileReader>::
+    Register<NativeMergeFileReader, std::string&&>(NativeMergeFileReader::m_id_factory);
+}
+
+NativeMergeFileReader::NativeMergeFileReader(const std::string& filenames)
+  :m_started(false), m_by_ts(false), m_read_ahead(1024), m_exit(false), m_ev_n(0){
+  for(auto &path: eudaq::split(filenames, ",", true)){
+    m_streams.emplace_back(new Stream);
+    m_streams.back()->path = path;
+  }
+  if(m_streams.empty())
+    EUDAQ_THROW("NativeMergeFileReader: no input file in <" + filenames + ">");
+}
+
+NativeMergeFileReader::~NativeMergeFileReader(){
+  m_exit = true;
+  for(auto &st: m_streams){
+    std::unique_lock<std::mutex> lk(st->mtx);
+    lk.unlock();
+    st->cv.notify_all();
+  }
+  for(auto &st: m_streams)
+    if(st->th.joinable())
+      st->th.join();
+}
+
+void NativeMergeFileReader::Start(){
+  auto conf = GetConfiguration();
+  if(conf){
+    std::string by = eudaq::lcase(conf->Get("MERGE_BY", "trigger"));
+    if(by == "timestamp")
+      m_by_ts = true;
+    else if(by != "trigger")
+      EUDAQ_THROW("NativeMergeFileReader: MERGE_BY must be trigger or timestamp, not " + by);
+    m_read_ahead = conf->Get("READ_AHEAD", 1024);
+    if(!m_read_ahead)
+      m_read_ahead = 1;
+  }
+  for(auto &st: m_streams)
+    st->th = std::thread(&NativeMergeFileReader::Reading, this, st.get());
+  m_started = true;
+}
+
+void NativeMergeFileReader::Reading(Stream *st){
+  try{
+    std::string type = st->path.substr(st->path.find_last_of(".")+1);
+    if(type == "raw")
+      type = "native";
+    auto reader = eudaq::FileReader::Make(type, st->path);
+    while(1){
+      auto ev = reader->GetNextEvent();
+      std::unique_lock<std::mutex> lk(st->mtx);
+      if(!ev || m_exit)
+	break;
+      st->cv.wait(lk, [&](){return m_exit || st->que.size() < m_read_ahead;});
+      st->que.push_back(ev);
+      lk.unlock();
+      st->cv.notify_all();
+    }
+  }
+  catch(...){
+    std::unique_lock<std::mutex> lk(st->mtx);
+    st->err = std::current_exception();
+  }
+  std::unique_lock<std::mutex> lk(st->mtx);
+  st->done = true;
+  lk.unlock();
+  st->cv.notify_all();
+}
+
+eudaq::EventSPC NativeMergeFileReader::Pop(Stream &st){
+  std::unique_lock<std::mutex> lk(st.mtx);
+  st.cv.wait(lk, [&](){return st.done || !st.que.empty();});
+  if(st.que.empty()){
+    if(st.err)
+      std::rethrow_exception(st.err);
+    return nullptr;
+  }
+  auto ev = std::move(st.que.front());
+  st.que.pop_front();
+  lk.unlock();
+  st.cv.notify_all();
+  return ev;
+}
+
+eudaq::EventSPC NativeMergeFileReader::GetNextEvent(){
+  if(!m_started){
+    Start();
+    for(auto &st: m_streams)
+      st->head = Pop(*st);
+  }
+
+  // the earliest head decides which events belong to the next packet
+  Stream *first = nullptr;
+  for(auto &st: m_streams){
+    if(!st->head)
+      continue;
+    if(!first)
+      first = st.get();
+    else if(m_by_ts ? st->head->GetTimestampBegin() < first->head->GetTimestampBegin()
+	    : st->head->GetTriggerN() < first->head->GetTriggerN())
+      first = st.get();
+  }
+  if(!first)
+    return nullptr;
+
+  auto ref = first->head;
+  static constexpr uint32_t dspt_hash = eudaq::cstr2hash("NativeMerge");
+  auto ev = eudaq::Event::MakeUnique("NativeMerge", dspt_hash);
+  ev->SetFlagPacket();
+  ev->SetRunN(ref->GetRunN());
+  ev->SetEventN(m_ev_n++);
+  uint64_t ts_begin = ref->GetTimestampBegin();
+  uint64_t ts_end = ref->GetTimestampEnd();
+  for(auto &st: m_streams){
+    if(!st->head)
+      continue;
+    bool match = m_by_ts ? st->head->GetTimestampBegin() <= ref->GetTimestampEnd()
+      : st->head->GetTriggerN() == ref->GetTriggerN();
+    if(!match)
+      continue;
+    if(st->head->GetTimestampBegin() < ts_begin)
+      ts_begin = st->head->GetTimestampBegin();
+    if(st->head->GetTimestampEnd() > ts_end)
+      ts_end = st->head->GetTimestampEnd();
+    ev->AddSubEvent(st->head);
+    st->head = Pop(*st);
+  }
+  if(m_by_ts)
+    ev->SetTimestamp(ts_begin, ts_end);
+  else
+    ev->SetTriggerN(ref->GetTriggerN());
+  return ev;
+}
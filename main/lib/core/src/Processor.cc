@@ -1,17 +1,25 @@
 #include "Processor.hh"
 #include "Utils.hh"
+#include "Logger.hh"
 
 using namespace eudaq;
 
 template DLLEXPORT
 std::map<uint32_t, typename Factory<Processor>::UP_BASE (*)()>& Factory<Processor>::Instance<>();
 
+namespace{
+  const size_t PS_BATCH_SIZE = 64;
+  const int64_t PS_QUEUE_SIZE = 4096;
+
+  int64_t NanoSeconds(std::chrono::steady_clock::duration d){
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+  }
+}
+
 ProcessorSP Processor::MakeShared(const std::string& pstype,
 				  std::initializer_list
 				  <std::pair<const std::string, const std::string>> l){
   ProcessorSP ps = Factory<Processor>::MakeShared(str2hash(pstype));
-  ps->m_th_hub = std::thread(&Processor::HubProcessing, ps.get());
-  ps->m_ps_hub = ps;
   for(auto &p: l){
     ps->ProcessSysCommand(p.first, p.second);
   }
@@ -20,21 +28,25 @@ ProcessorSP Processor::MakeShared(const std::string& pstype,
 
 
 Processor::Processor(const std::string& dsp)
-  :m_description(dsp), m_csm_go_stop(0), m_hub_go_stop(0), m_hub_force(0){
+  :m_description(dsp), m_ps_downstream(std::make_shared<Downstreams>()),
+   m_scheduled(0), m_consuming(0), m_ordered(1), m_que_size(PS_QUEUE_SIZE),
+   m_que_policy(QueuePolicy::BLOCK), m_sample_n(10), m_sample_c(0), m_n_wait(0),
+   m_pdc_go_stop(0){
   m_instance_n = static_cast<uint32_t>(reinterpret_cast<uint64_t>(this));
 }
 
 Processor::~Processor(){
   StopProducer();
-  if(m_th_hub.joinable()){
-    m_hub_go_stop = true;
-    m_th_hub.join();
-    m_hub_go_stop = false;
-  }
-  if(m_th_csm.joinable()){
-    m_csm_go_stop = true;
-    m_th_csm.join();
-    m_csm_go_stop = false;
+  // a pending Drain task keeps the processor alive, so what is left here
+  // arrived after the last one and can no longer reach the derived class
+  QueuedEvent left;
+  uint64_t n_left = 0;
+  while(m_que_in.Pop(left))
+    n_left++;
+  if(n_left){
+    m_met_drop.Add(n_left);
+    EUDAQ_WARN("Processor "+m_description+": "+std::to_string(n_left)+
+	       " queued events dropped at destruction");
   }
 };
 
@@ -42,22 +54,10 @@ void Processor::ProcessEvent(EventSPC ev){
   ForwardEvent(ev);
 }
 
-void Processor::Processing(EventSPC ev){
-  if(m_th_csm.joinable() && !m_csm_go_stop){
-    std::unique_lock<std::mutex> lk(m_mtx_csm);
-    m_que_csm.push_back(ev);
-    m_cv_csm.notify_all();
-  }
-  else{
-    ProcessEvent(ev);
-  }
-}
-
-
 void Processor::ForwardEvent(EventSPC ev) {
-  std::lock_guard<std::mutex> lk(m_mtx_output);
+  auto downstream = std::atomic_load(&m_ps_downstream);
   uint32_t evid = ev->GetEventID();
-  for(auto &psev: m_ps_downstream){
+  for(auto &psev: *downstream){
     auto &evset = psev.second;
     if(evset.find(evid)!=evset.end()){
       psev.first->RegisterEvent(ev);
@@ -66,128 +66,132 @@ void Processor::ForwardEvent(EventSPC ev) {
 }
 
 void Processor::RegisterEvent(EventSPC ev){
-  std::lock_guard<std::mutex> lk(m_mtx_input);
-  auto ps_hub = m_ps_hub.lock();
-  ps_hub->RegisterProcessing(shared_from_this(), ev);
+  if(!AcceptEvent()){
+    m_met_drop.Add();
+    return;
+  }
+  m_que_in.Push(QueuedEvent{std::move(ev), std::chrono::steady_clock::now()});
+  m_met_in.Add();
+  int64_t depth = m_que_in.Size();
+  if(depth > m_met_depth_max.Get())
+    m_met_depth_max.Set(depth);
+  if(!m_consuming && !m_scheduled.exchange(true)){
+    ProcessorSP ps = shared_from_this();
+    TaskPool::Instance().Submit([ps](){ps->Drain();});
+  }
 }
 
-void Processor::RegisterDownstream(ProcessorSP ps, const std::set<uint32_t>& evset){
-  std::lock_guard<std::mutex> lk(m_mtx_output);
-  auto evs = evset;
-  if(evs.empty())
-    evs=m_ev_out_default;
-  bool found = false;
-  for(auto &psev: m_ps_downstream){
-    if(ps == psev.first){
-      psev.second.insert(evs.begin(), evs.end());
-      found = true;
-      break;
-    }
+bool Processor::AcceptEvent(){
+  int64_t size = m_que_size;
+  if(size <= 0)
+    return true;
+  switch(m_que_policy.load()){
+  case QueuePolicy::DROP:
+    return m_que_in.Size() < size;
+  case QueuePolicy::SAMPLE:{
+    int64_t depth = m_que_in.Size();
+    if(depth < size/2)
+      return true;
+    uint32_t n = m_sample_n;
+    return depth < size && (n < 2 || m_sample_c++ % n == 0);
   }
-  if(!found){
-    m_ps_downstream.push_back(std::make_pair(ps, evs));
-    ps->RegisterUpstream(shared_from_this(), m_ps_hub);
+  default:
+    break;
   }
+  while(m_que_in.Size() >= m_que_size){
+    // rather than only waiting, process a batch here if nobody else is
+    if(Consume())
+      continue;
+    std::unique_lock<std::mutex> lk(m_mtx_space);
+    m_n_wait++;
+    m_cv_space.wait_for(lk, std::chrono::milliseconds(1),
+			[this](){return m_que_in.Size() < m_que_size;});
+    m_n_wait--;
+  }
+  return true;
 }
 
+void Processor::Drain(){
+  m_scheduled = false;
+  Consume();
+}
 
-void Processor::RegisterUpstream(ProcessorSP up, ProcessorWP hub){
-  std::lock_guard<std::mutex> lk(m_mtx_input);
-  bool found = false;
-  for(auto &ps: m_ps_upstream){
-    if(up == ps.lock()){
-      found = true;
-      break;
+bool Processor::Consume(){
+  if(m_consuming.exchange(true))
+    return false;
+  QueuedEvent batch[PS_BATCH_SIZE];
+  size_t n = 0;
+  while(n < PS_BATCH_SIZE && m_que_in.Pop(batch[n]))
+    n++;
+  if(n && m_n_wait){
+    {
+      std::lock_guard<std::mutex> lk(m_mtx_space);
     }
+    m_cv_space.notify_all();
   }
-  if(!found)
-    m_ps_upstream.push_back(up);
-
-  //same
-  if(m_ps_hub.lock() == hub.lock())
-    return;
-  //forced
-  if(m_hub_force)
-    return;
-  //unforced, diff, single upstream
-  if(m_ps_upstream.size() < 2){
-    bool to_stop = false;
-    //unforced, diff, single upstream, self hub
-    if(m_ps_hub.lock() == shared_from_this()){
-      to_stop = true;
+  bool ordered = m_ordered;
+  if(!ordered)
+    Release();
+  for(size_t i = 0; i < n; i++){
+    auto t_start = std::chrono::steady_clock::now();
+    int64_t wait = NanoSeconds(t_start - batch[i].t_in);
+    m_met_wait_ns.Add(wait);
+    if(wait > m_met_wait_max_ns.Get())
+      m_met_wait_max_ns.Set(wait);
+    try{
+      ProcessEvent(std::move(batch[i].ev));
     }
-    //else, unforced, diff, single upstream, other hub
-    m_ps_hub = hub;
-    for(auto &e: m_ps_downstream){
-      e.first->RegisterUpstream(shared_from_this(), m_ps_hub);
+    catch(const std::exception &e){
+      EUDAQ_ERROR("Processor "+m_description+": Uncaught exception: "+e.what());
     }
-    if(to_stop && m_th_hub.joinable()){
-	m_hub_go_stop = true;
-	m_th_hub.join();
+    catch(...){
+      EUDAQ_ERROR("Processor "+m_description+": Uncaught unrecognised exception");
     }
-    return;
-  }
-  //unforced, diff, muilt upstreams, self hub ready
-  if(m_ps_hub.lock() == shared_from_this()){
-    return;
+    m_met_proc_ns.Add(NanoSeconds(std::chrono::steady_clock::now() - t_start));
+    m_met_done.Add();
   }
-  //unforced, diff, muilt upstreams, self hub unready  
-  m_th_hub = std::thread(&Processor::HubProcessing, this);
-  m_ps_hub = shared_from_this();
-  for(auto &e: m_ps_downstream){
-    e.first->RegisterUpstream(shared_from_this(),  m_ps_hub);
-  }
-  return;
+  if(ordered)
+    Release();
+  return n > 0;
 }
 
-
-void Processor::RegisterProcessing(ProcessorSP ps, EventSPC ev){ //NOTE:: return ps_hub_wk if not sucess
-  std::unique_lock<std::mutex> lk(m_mtx_hub);
-  if(m_hub_go_stop){
-    lk.unlock();
-    return; //register to new hub_ps of that ps
-  }
-  m_que_hub.push_back(std::make_pair(ps, ev));
-  m_cv_hub.notify_all();
+void Processor::Release(){
+  m_consuming = false;
+  if(m_que_in.Size() > 0 && !m_scheduled.exchange(true)){
+    ProcessorSP ps = shared_from_this();
+    TaskPool::Instance().Submit([ps](){ps->Drain();});
+  }
 }
 
-void Processor::HubProcessing(){
-  while(!m_hub_go_stop){
-    std::unique_lock<std::mutex> lk(m_mtx_hub);
-    if(m_que_hub.empty()){
-      if(m_cv_hub.wait_for(lk,std::chrono::microseconds(100))==std::cv_status::timeout)
-	continue;
+void Processor::RegisterDownstream(ProcessorSP ps, const std::set<uint32_t>& evset){
+  std::lock_guard<std::mutex> lk(m_mtx_output);
+  auto evs = evset;
+  if(evs.empty())
+    evs=m_ev_out_default;
+  auto downstream = std::make_shared<Downstreams>(*m_ps_downstream);
+  bool found = false;
+  for(auto &psev: *downstream){
+    if(ps == psev.first){
+      psev.second.insert(evs.begin(), evs.end());
+      found = true;
+      break;
     }
-    ProcessorSP ps = m_que_hub.front().first;
-    EventSPC ev(m_que_hub.front().second);
-    m_que_hub.pop_front();
-    lk.unlock();
-    ps->Processing(ev);
-  }
-  std::unique_lock<std::mutex> lk(m_mtx_hub);
-  for(auto &ps_ev: m_que_hub){
-    ps_ev.first->Processing(ps_ev.second);
   }
-  m_que_hub.clear();
+  if(!found)
+    downstream->push_back(std::make_pair(ps, evs));
+  std::atomic_store(&m_ps_downstream, std::shared_ptr<const Downstreams>(downstream));
+  if(!found)
+    ps->RegisterUpstream(shared_from_this());
 }
 
-void Processor::ConsumeEvent(){
-  while(!m_csm_go_stop){
-    std::unique_lock<std::mutex> lk(m_mtx_csm);
-    if(m_que_csm.empty()){
-      if(m_cv_csm.wait_for(lk,std::chrono::microseconds(100))==std::cv_status::timeout)
-	continue;
-    }
-    EventSPC ev(m_que_csm.front());
-    m_que_csm.pop_front();
-    lk.unlock();
-    ProcessEvent(ev);
-  }
-  std::unique_lock<std::mutex> lk(m_mtx_csm);
-  for(auto &ev: m_que_csm){
-    ProcessEvent(ev);
+
+void Processor::RegisterUpstream(ProcessorSP up){
+  std::lock_guard<std::mutex> lk(m_mtx_input);
+  for(auto &ps: m_ps_upstream){
+    if(up == ps.lock())
+      return;
   }
-  m_que_csm.clear();
+  m_ps_upstream.push_back(up);
 }
 
 void Processor::StopProducer(){
@@ -213,25 +217,43 @@ void Processor::ProcessSysCommand(const std::string& cmd, const std::string& arg
     StopProducer();
     break;
   }
-  case cstr2hash("SYS:CS:RUN"):{
-    m_th_csm = std::thread(&Processor::ConsumeEvent, this);
+  case cstr2hash("SYS:OD:ON"):
+  case cstr2hash("SYS:CS:RUN"):
+  case cstr2hash("SYS:HB:FORCE"):{
+    m_ordered = true;
+    break;
+  }
+  case cstr2hash("SYS:OD:OFF"):{
+    m_ordered = false;
     break;
   }
   case cstr2hash("SYS:CS:STOP"):{
-    if(m_th_csm.joinable()){
-      m_csm_go_stop = true;
-      m_th_csm.join();
-      m_csm_go_stop = false;
-    }
+    // there is no consumer thread to stop any more
     break;
   }
-  case cstr2hash("SYS:HB:FORCE"):{
-    std::lock_guard<std::mutex> lk(m_mtx_input);
-    m_hub_force = true;
-    if(m_ps_hub.lock()!=shared_from_this()){
-      m_th_hub = std::thread(&Processor::HubProcessing, this);
-      m_ps_hub = shared_from_this();
+  case cstr2hash("SYS:QU:SIZE"):{
+    m_que_size = std::stoll(arg);
+    break;
+  }
+  case cstr2hash("SYS:QU:POLICY"):{
+    switch(str2hash(arg)){
+    case cstr2hash("block"):
+      m_que_policy = QueuePolicy::BLOCK;
+      break;
+    case cstr2hash("drop"):
+      m_que_policy = QueuePolicy::DROP;
+      break;
+    case cstr2hash("sample"):
+      m_que_policy = QueuePolicy::SAMPLE;
+      break;
+    default:
+      EUDAQ_THROW("Processor "+m_description+": unknown queue policy "+arg);
     }
+    break;
+  }
+  case cstr2hash("SYS:QU:SAMPLE"):{
+    m_sample_n = std::stoul(arg);
+    break;
   }
   case cstr2hash("SYS:EV:ADD"):{
     std::lock_guard<std::mutex> lk(m_mtx_output);
@@ -258,7 +280,23 @@ void Processor::Print(std::ostream &os, uint32_t offset) const{
   os << std::string(offset, ' ') << "<Processor>\n";
   os << std::string(offset + 2, ' ') << "<Description> " << m_description <<" </Description>\n";
   os << std::string(offset + 2, ' ') << "<InstanceN> " << m_instance_n << " </InstanceN>\n";
-  os << std::string(offset + 2, ' ') << "<HubInstanceN> " << m_ps_hub.lock()->m_instance_n << " </HubInstanceN>\n";
+  os << std::string(offset + 2, ' ') << "<Ordered> " << m_ordered << " </Ordered>\n";
+  const char *policy[] = {"block", "drop", "sample"};
+  uint64_t n_done = m_met_done.Get();
+  os << std::string(offset + 2, ' ') << "<Queue>\n";
+  os << std::string(offset + 4, ' ') << "<Size> " << m_que_size << " </Size>\n";
+  os << std::string(offset + 4, ' ') << "<Policy> " << policy[static_cast<int>(m_que_policy.load())] << " </Policy>\n";
+  os << std::string(offset + 4, ' ') << "<Depth> " << m_que_in.Size() << " </Depth>\n";
+  os << std::string(offset + 4, ' ') << "<MaxDepth> " << m_met_depth_max.Get() << " </MaxDepth>\n";
+  os << std::string(offset + 4, ' ') << "<Accepted> " << m_met_in.Get() << " </Accepted>\n";
+  os << std::string(offset + 4, ' ') << "<Dropped> " << m_met_drop.Get() << " </Dropped>\n";
+  os << std::string(offset + 4, ' ') << "<Processed> " << n_done << " </Processed>\n";
+  if(n_done){
+    os << std::string(offset + 4, ' ') << "<MeanWaitUs> " << m_met_wait_ns.Get()*1e-3/n_done << " </MeanWaitUs>\n";
+    os << std::string(offset + 4, ' ') << "<MaxWaitUs> " << m_met_wait_max_ns.Get()*1e-3 << " </MaxWaitUs>\n";
+    os << std::string(offset + 4, ' ') << "<MeanProcessUs> " << m_met_proc_ns.Get()*1e-3/n_done << " </MeanProcessUs>\n";
+  }
+  os << std::string(offset + 2, ' ') << "</Queue>\n";
   if(!m_ps_upstream.empty()){
     os << std::string(offset + 2, ' ') << "<Upstreams> \n";
     for (auto &pswp: m_ps_upstream){
@@ -266,9 +304,10 @@ void Processor::Print(std::ostream &os, uint32_t offset) const{
     }
     os << std::string(offset + 2, ' ') << "</Upstreams> \n";
   }
-  if(!m_ps_downstream.empty()){
+  auto downstream = std::atomic_load(&m_ps_downstream);
+  if(!downstream->empty()){
     os << std::string(offset + 2, ' ') << "<Downstreams> \n";
-    for (auto &psev: m_ps_downstream){
+    for (auto &psev: *downstream){
       os << std::string(offset+4, ' ') << "<Processor> "<< psev.first->m_description << "=" << psev.first->m_instance_n << " </Processor>\n";
     }
     os << std::string(offset + 2, ' ') << "</Downstreams> \n";
@@ -1,5 +1,6 @@
 #include "eudaq/TransportClient.hh"
 #include "eudaq/Producer.hh"
+#include "eudaq/LatencyTracer.hh"
 
 namespace eudaq {
 
@@ -9,7 +10,9 @@ namespace eudaq {
   Factory<Producer>::Instance<const std::string&, const std::string&>();  
   
   Producer::Producer(const std::string &name, const std::string &runcontrol)
-    : CommandReceiver("Producer", name, runcontrol){
+    : CommandReceiver("Producer", name, runcontrol),
+      m_mtr_evt(GetMetrics().Counter("Events")),
+      m_mtr_byte(GetMetrics().Counter("Bytes", "B")){
     m_evt_c = 0;
     m_pdc_n = str2hash(GetFullName());
   }
@@ -141,6 +144,7 @@ namespace eudaq {
     try{
       SetStatusTag("EventN", std::to_string(m_evt_c));
       DoStatus();
+      CommandReceiver::OnStatus();
     }catch (const std::exception &e) {
       printf("Caught exception: %s\n", e.what());
       SetStatus(Status::STATE_ERROR, "Status Error");
@@ -151,6 +155,7 @@ namespace eudaq {
   }
   
   void Producer::SendEvent(EventSP ev){
+    LatencyTraceScope trace(LatencyTracer::STAGE_PRODUCER_SEND);
     if(ev->IsBORE()){
       if(GetConfiguration())
 	ev->SetTag("EUDAQ_CONFIG", to_string(*GetConfiguration()));
@@ -160,13 +165,15 @@ namespace eudaq {
     ev->SetRunN(GetRunNumber());
     ev->SetEventN(m_evt_c);
     m_evt_c ++;
+    trace.SetEventN(ev->GetEventN());
     ev->SetDeviceN(m_pdc_n);
     std::unique_lock<std::mutex> lk(m_mtx_sender);
     auto senders = m_senders; //hold on the ptrs
     lk.unlock();
+    m_mtr_evt.Add();
     for(auto &e: senders){
       if(e.second)
-	e.second->SendEvent(ev);
+	m_mtr_byte.Add(e.second->SendEvent(ev));
       else
 	EUDAQ_THROW("Producer::SendEvent, using a null pointer of DataSender");
     }
@@ -55,4 +55,31 @@ namespace eudaq {
     m_planes.push_back(plane);
     return m_planes.back();
   }
+
+  StandardPlane &StandardEvent::AddPlane(StandardPlane &&plane) {
+    m_planes.push_back(std::move(plane));
+    return m_planes.back();
+  }
+
+  // A new empty plane, built in place. After Recycle() it reuses the pixel
+  // storage of a plane from the previous event.
+  StandardPlane &StandardEvent::AddPlane(uint32_t id, const std::string &type,
+					 const std::string &sensor) {
+    if(m_spare_planes.empty()){
+      m_planes.emplace_back(id, type, sensor);
+      return m_planes.back();
+    }
+    m_planes.push_back(std::move(m_spare_planes.back()));
+    m_spare_planes.pop_back();
+    m_planes.back().Reset(id, type, sensor);
+    return m_planes.back();
+  }
+
+  void StandardEvent::Recycle(){
+    Event::Recycle();
+    // reversed, so that AddPlane hands out the same storage in the same order
+    for(auto it = m_planes.rbegin(); it != m_planes.rend(); ++it)
+      m_spare_planes.push_back(std::move(*it));
+    m_planes.clear();
+  }
 }
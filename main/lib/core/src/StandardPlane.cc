@@ -11,6 +11,87 @@ namespace eudaq{
       m_ysize(0), m_flags(0), m_pivotpixel(0), m_result_pix(0), m_result_x(0),
       m_result_y(0) {}
 
+  // the cached result may point into the other plane, it is built again on
+  // first use
+  StandardPlane::StandardPlane(const StandardPlane &p)
+    : m_type(p.m_type), m_sensor(p.m_sensor), m_id(p.m_id),
+      m_xsize(p.m_xsize), m_ysize(p.m_ysize), m_flags(p.m_flags),
+      m_pivotpixel(p.m_pivotpixel), m_pix(p.m_pix), m_x(p.m_x), m_y(p.m_y),
+      m_pivot(p.m_pivot), m_mat(p.m_mat),
+      m_result_pix(0), m_result_x(0), m_result_y(0) {}
+
+  StandardPlane::StandardPlane(StandardPlane &&p) noexcept
+    : m_type(std::move(p.m_type)), m_sensor(std::move(p.m_sensor)), m_id(p.m_id),
+      m_xsize(p.m_xsize), m_ysize(p.m_ysize), m_flags(p.m_flags),
+      m_pivotpixel(p.m_pivotpixel), m_pix(std::move(p.m_pix)),
+      m_x(std::move(p.m_x)), m_y(std::move(p.m_y)),
+      m_pivot(std::move(p.m_pivot)), m_mat(std::move(p.m_mat)),
+      m_result_pix(0), m_result_x(0), m_result_y(0) {
+    p.ClearResult();
+  }
+
+  StandardPlane &StandardPlane::operator=(const StandardPlane &p) {
+    if (this == &p)
+      return *this;
+    m_type = p.m_type;
+    m_sensor = p.m_sensor;
+    m_id = p.m_id;
+    m_xsize = p.m_xsize;
+    m_ysize = p.m_ysize;
+    m_flags = p.m_flags;
+    m_pivotpixel = p.m_pivotpixel;
+    m_pix = p.m_pix;
+    m_x = p.m_x;
+    m_y = p.m_y;
+    m_pivot = p.m_pivot;
+    m_mat = p.m_mat;
+    ClearResult();
+    return *this;
+  }
+
+  StandardPlane &StandardPlane::operator=(StandardPlane &&p) noexcept {
+    if (this == &p)
+      return *this;
+    m_type = std::move(p.m_type);
+    m_sensor = std::move(p.m_sensor);
+    m_id = p.m_id;
+    m_xsize = p.m_xsize;
+    m_ysize = p.m_ysize;
+    m_flags = p.m_flags;
+    m_pivotpixel = p.m_pivotpixel;
+    m_pix = std::move(p.m_pix);
+    m_x = std::move(p.m_x);
+    m_y = std::move(p.m_y);
+    m_pivot = std::move(p.m_pivot);
+    m_mat = std::move(p.m_mat);
+    ClearResult();
+    p.ClearResult();
+    return *this;
+  }
+
+  // Makes the plane look like a newly constructed one, but keeps the memory
+  // of the pixel vectors. SetSizeZS/SetSizeRaw has to be called again.
+  void StandardPlane::Reset(uint32_t id, const std::string &type,
+			    const std::string &sensor) {
+    m_type = type;
+    m_sensor = sensor;
+    m_id = id;
+    m_xsize = 0;
+    m_ysize = 0;
+    m_flags = 0;
+    m_pivotpixel = 0;
+    for (auto &v : m_pix)
+      v.clear();
+    for (auto &v : m_x)
+      v.clear();
+    for (auto &v : m_y)
+      v.clear();
+    for (auto &v : m_pivot)
+      v.clear();
+    m_mat.clear();
+    ClearResult();
+  }
+
   StandardPlane::StandardPlane(Deserializer &ds)
     : m_result_pix(0), m_result_x(0), m_result_y(0) {
     ds.read(m_type);
@@ -220,6 +301,12 @@ namespace eudaq{
     return v.at(f);
   }
 
+  void StandardPlane::ClearResult() const {
+    m_result_pix = 0;
+    m_result_x = 0;
+    m_result_y = 0;
+  }
+
   void StandardPlane::SetupResult() const {
     if (m_result_pix)
       return;
@@ -0,0 +1,117 @@
+#include "eudaq/TaskPool.hh"
+
+namespace eudaq {
+  namespace{
+    thread_local TaskPool *t_pool = nullptr;
+    thread_local uint32_t t_worker = 0;
+    std::atomic<uint32_t> s_n_default(0);
+  }
+
+  TaskPool& TaskPool::Instance(){
+    static TaskPool pool(s_n_default);
+    return pool;
+  }
+
+  void TaskPool::SetDefaultNumWorkers(uint32_t n){
+    s_n_default = n;
+  }
+
+  TaskPool::TaskPool(uint32_t n_worker)
+    :m_next(0), m_queued(0), m_pending(0), m_sleeping(0), m_exit(false){
+    if(!n_worker)
+      n_worker = std::thread::hardware_concurrency();
+    if(n_worker < 2)
+      n_worker = 2;
+    for(uint32_t i = 0; i < n_worker; i++)
+      m_workers.emplace_back(new Worker);
+    for(uint32_t i = 0; i < n_worker; i++)
+      m_workers[i]->th = std::thread(&TaskPool::Run, this, i);
+  }
+
+  TaskPool::~TaskPool(){
+    {
+      std::lock_guard<std::mutex> lk(m_mtx_sleep);
+      m_exit = true;
+    }
+    m_cv_sleep.notify_all();
+    for(auto &w: m_workers)
+      if(w->th.joinable())
+	w->th.join();
+  }
+
+  void TaskPool::Submit(Task t){
+    uint32_t n;
+    if(t_pool == this)
+      n = t_worker;
+    else
+      n = m_next++ % m_workers.size();
+    m_pending++;
+    {
+      std::lock_guard<std::mutex> lk(m_workers[n]->mtx);
+      m_workers[n]->que.push_back(std::move(t));
+    }
+    m_queued++;
+    if(m_sleeping.load()){
+      {
+	std::lock_guard<std::mutex> lk(m_mtx_sleep);
+      }
+      m_cv_sleep.notify_one();
+    }
+  }
+
+  void TaskPool::WaitIdle(){
+    std::unique_lock<std::mutex> lk(m_mtx_sleep);
+    m_cv_idle.wait(lk, [this](){return m_pending.load() == 0 || m_exit;});
+  }
+
+  bool TaskPool::PopTask(uint32_t n, Task &t){
+    {
+      Worker &w = *m_workers[n];
+      std::lock_guard<std::mutex> lk(w.mtx);
+      if(!w.que.empty()){
+	t = std::move(w.que.back());
+	w.que.pop_back();
+	m_queued--;
+	return true;
+      }
+    }
+    for(uint32_t i = 1; i < m_workers.size(); i++){
+      Worker &w = *m_workers[(n + i) % m_workers.size()];
+      std::unique_lock<std::mutex> lk(w.mtx, std::try_to_lock);
+      if(lk.owns_lock() && !w.que.empty()){
+	t = std::move(w.que.front());
+	w.que.pop_front();
+	m_queued--;
+	return true;
+      }
+    }
+    return false;
+  }
+
+  void TaskPool::Run(uint32_t n){
+    t_pool = this;
+    t_worker = n;
+    Task t;
+    while(true){
+      if(PopTask(n, t)){
+	t();
+	t = nullptr;
+	if(--m_pending == 0){
+	  {
+	    std::lock_guard<std::mutex> lk(m_mtx_sleep);
+	  }
+	  m_cv_idle.notify_all();
+	}
+	continue;
+      }
+      std::unique_lock<std::mutex> lk(m_mtx_sleep);
+      if(m_exit)
+	break;
+      m_sleeping++;
+      // a steal may have missed a locked deque, so look again now and then
+      m_cv_sleep.wait_for(lk, std::chrono::milliseconds(10),
+			  [this](){return m_queued.load() > 0 || m_exit;});
+      m_sleeping--;
+    }
+  }
+}
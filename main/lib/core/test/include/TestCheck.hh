@@ -0,0 +1,16 @@
+#ifndef EUDAQ_INCLUDED_TestCheck
+#define EUDAQ_INCLUDED_TestCheck
+
+#include <iostream>
+#include <cstdlib>
+
+// ends the test with a failure, naming the condition and where it is
+#define EUDAQ_CHECK(cond)						\
+  do{									\
+    if(!(cond)){							\
+      std::cerr<<__FILE__<<":"<<__LINE__<<": check failed: "<<#cond<<std::endl; \
+      std::exit(1);							\
+    }									\
+  }while(0)
+
+#endif // EUDAQ_INCLUDED_TestCheck
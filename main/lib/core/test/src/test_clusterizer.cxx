@@ -0,0 +1,97 @@
+#include "eudaq/Clusterizer.hh"
+#include "TestCheck.hh"
+
+#include <cstdlib>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace{
+  using Pixels = std::vector<std::pair<int32_t, int32_t>>;
+
+  // cluster of every pixel by a flood fill over all pairs
+  std::vector<uint32_t> SlowLabels(const Pixels &pix, int32_t dx, int32_t dy){
+    std::vector<uint32_t> label(pix.size(), UINT32_MAX);
+    uint32_t n = 0;
+    for(size_t s = 0; s < pix.size(); s++){
+      if(label[s] != UINT32_MAX)
+	continue;
+      std::vector<size_t> todo(1, s);
+      label[s] = n;
+      while(!todo.empty()){
+	size_t i = todo.back();
+	todo.pop_back();
+	for(size_t j = 0; j < pix.size(); j++)
+	  if(label[j] == UINT32_MAX &&
+	     std::abs(pix[i].first - pix[j].first) <= dx &&
+	     std::abs(pix[i].second - pix[j].second) <= dy){
+	    label[j] = n;
+	    todo.push_back(j);
+	  }
+      }
+      n++;
+    }
+    return label;
+  }
+
+  // the same partition, whatever the numbering
+  bool SamePartition(const std::vector<uint32_t> &a, const std::vector<uint32_t> &b){
+    if(a.size() != b.size())
+      return false;
+    for(size_t i = 0; i < a.size(); i++)
+      for(size_t j = i + 1; j < a.size(); j++)
+	if((a[i] == a[j]) != (b[i] == b[j]))
+	  return false;
+    return true;
+  }
+
+  void Check(eudaq::Clusterizer &cl, const Pixels &pix, int32_t dx, int32_t dy){
+    cl.Clear();
+    cl.SetNeighbourDistance(dx, dy);
+    for(auto &p: pix)
+      cl.AddPixel(p.first, p.second);
+    size_t n = cl.Run();
+    auto slow = SlowLabels(pix, dx, dy);
+    EUDAQ_CHECK(n == std::set<uint32_t>(slow.begin(), slow.end()).size());
+    EUDAQ_CHECK(SamePartition(cl.GetLabels(), slow));
+    // every pixel is listed once, under its own cluster
+    auto &order = cl.GetOrder();
+    auto &offset = cl.GetOffsets();
+    EUDAQ_CHECK(offset.size() == n + 1 && offset.back() == pix.size());
+    std::set<uint32_t> seen;
+    for(uint32_t c = 0; c < n; c++)
+      for(uint32_t k = offset[c]; k < offset[c+1]; k++){
+	EUDAQ_CHECK(cl.GetLabels()[order[k]] == c);
+	seen.insert(order[k]);
+      }
+    EUDAQ_CHECK(seen.size() == pix.size());
+  }
+}
+
+int main(){
+  eudaq::Clusterizer cl;
+  cl.Run();
+  EUDAQ_CHECK(cl.NumClusters() == 0);
+
+  // a diagonal pair, a lone pixel and an L shape, with negative columns
+  Check(cl, {{0, 0}, {1, 1}, {5, 5}, {-3, 0}, {-3, 1}, {-2, 1}}, 1, 1);
+  EUDAQ_CHECK(cl.NumClusters() == 3);
+  // a gap of one column joins only with a distance of 2
+  Check(cl, {{0, 0}, {2, 0}}, 1, 1);
+  EUDAQ_CHECK(cl.NumClusters() == 2);
+  Check(cl, {{0, 0}, {2, 0}}, 2, 1);
+  EUDAQ_CHECK(cl.NumClusters() == 1);
+  // duplicated pixels belong together
+  Check(cl, {{4, 4}, {4, 4}}, 1, 1);
+
+  std::mt19937 rng(2024);
+  for(int round = 0; round < 200; round++){
+    std::uniform_int_distribution<int32_t> coord(0, 20 + round % 40);
+    Pixels pix(1 + round % 60);
+    for(auto &p: pix)
+      p = std::make_pair(coord(rng), coord(rng));
+    Check(cl, pix, 1 + round % 3, 1 + round % 2);
+  }
+  return 0;
+}
@@ -0,0 +1,118 @@
+#include "eudaq/Crc32c.hh"
+#include "eudaq/FileWriter.hh"
+#include "eudaq/FileDeserializer.hh"
+#include "eudaq/NativeFileIndex.hh"
+#include "TestCheck.hh"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace{
+  // bit by bit, as in RFC 3720
+  uint32_t Crc32cBits(const uint8_t *data, size_t len){
+    uint32_t crc = 0xffffffff;
+    for(size_t i = 0; i < len; i++){
+      crc ^= data[i];
+      for(int k = 0; k < 8; k++)
+	crc = (crc >> 1) ^ (0x82f63b78 & (0 - (crc & 1)));
+    }
+    return ~crc;
+  }
+
+  std::vector<uint8_t> ReadAll(const std::string &path){
+    eudaq::FileDeserializer des(path);
+    std::vector<uint8_t> data(des.FileSize());
+    des.read(&data[0], data.size());
+    return data;
+  }
+
+  void WriteAll(const std::string &path, const std::vector<uint8_t> &data){
+    FILE *fd = std::fopen(path.c_str(), "wb");
+    EUDAQ_CHECK(fd);
+    EUDAQ_CHECK(std::fwrite(&data[0], 1, data.size(), fd) == data.size());
+    std::fclose(fd);
+  }
+
+  // number of event frames whose checksum does not match
+  size_t BadFrames(const std::string &path){
+    eudaq::FileDeserializer des(path);
+    EUDAQ_CHECK(des.FormatVersion() == 2);
+    std::vector<uint8_t> frame;
+    size_t n_bad = 0;
+    while(des.ReadFrame(frame)){
+      uint32_t crc;
+      EUDAQ_CHECK(frame.size() >= sizeof(crc));
+      size_t len = frame.size() - sizeof(crc);
+      std::memcpy(&crc, &frame[len], sizeof(crc));
+      if(crc != eudaq::Crc32c(0, &frame[0], len))
+	n_bad++;
+    }
+    return n_bad;
+  }
+}
+
+int main(){
+  // the check value of the CRC-32C catalogue
+  EUDAQ_CHECK(eudaq::Crc32c(0, "123456789", 9) == 0xe3069283);
+  EUDAQ_CHECK(eudaq::Crc32c(0, "", 0) == 0);
+
+  // any start and length, in one go or piece by piece
+  std::vector<uint8_t> data(1000);
+  for(size_t i = 0; i < data.size(); i++)
+    data[i] = uint8_t(i * 131 + 17);
+  for(size_t begin = 0; begin < 9; begin++){
+    for(size_t len = 0; len < 40; len++){
+      uint32_t crc = eudaq::Crc32c(0, &data[begin], len);
+      EUDAQ_CHECK(crc == Crc32cBits(&data[begin], len));
+      for(size_t cut = 0; cut <= len; cut++)
+	EUDAQ_CHECK(eudaq::Crc32c(eudaq::Crc32c(0, &data[begin], cut),
+				  &data[begin + cut], len - cut) == crc);
+    }
+  }
+  EUDAQ_CHECK(eudaq::Crc32c(0, &data[3], 997) == Crc32cBits(&data[3], 997));
+
+  // the checksums of a native file, good and broken
+  const std::string good = "test_crc32c.raw";
+  const std::string bad_event = "test_crc32c_badevent.raw";
+  const std::string bad_footer = "test_crc32c_badfooter.raw";
+  std::remove(good.c_str());
+  {
+    auto fw = eudaq::FileWriter::Make("native", "test_crc32c$X");
+    fw->SetConfiguration(std::make_shared<eudaq::Configuration>());
+    for(uint32_t i = 0; i < 20; i++){
+      auto ev = eudaq::Event::MakeShared("TestRaw");
+      ev->SetEventN(i);
+      ev->AddBlock(0, std::vector<uint8_t>(100, uint8_t(i)));
+      fw->WriteEvent(ev);
+    }
+  }
+  EUDAQ_CHECK(BadFrames(good) == 0);
+  eudaq::NativeFileIndex idx;
+  EUDAQ_CHECK(eudaq::NativeFileIndex::ReadFooter(good, idx));
+  EUDAQ_CHECK(idx.NumEvents() == 20);
+
+  // a flipped bit in the block data of event 5
+  std::vector<uint8_t> file = ReadAll(good);
+  std::vector<uint8_t> broken = file;
+  broken[idx.m_offsets[6] - 20] ^= 0x10;
+  WriteAll(bad_event, broken);
+  EUDAQ_CHECK(BadFrames(bad_event) == 1);
+  EUDAQ_CHECK(eudaq::NativeFileIndex::ReadFooter(bad_event, idx));
+
+  // and one in the index of the footer
+  broken = file;
+  uint64_t footer = 0;
+  std::memcpy(&footer, &file[file.size() - 16], sizeof(footer));
+  broken[footer + 30] ^= 0x10;
+  WriteAll(bad_footer, broken);
+  bool thrown = false;
+  try{
+    eudaq::NativeFileIndex::ReadFooter(bad_footer, idx);
+  }
+  catch(const eudaq::Exception &){
+    thrown = true;
+  }
+  EUDAQ_CHECK(thrown);
+  return 0;
+}
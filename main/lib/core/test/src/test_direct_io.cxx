@@ -0,0 +1,77 @@
+#include "eudaq/FileSerializer.hh"
+#include "eudaq/FileDeserializer.hh"
+#include "eudaq/FileWriter.hh"
+#include "eudaq/NativeFileIndex.hh"
+#include "TestCheck.hh"
+
+#include <cstdio>
+#include <vector>
+
+namespace{
+  std::vector<uint8_t> ReadAll(const std::string &path){
+    FILE *fd = std::fopen(path.c_str(), "rb");
+    EUDAQ_CHECK(fd);
+    std::vector<uint8_t> data;
+    int c;
+    while((c = std::fgetc(fd)) != EOF)
+      data.push_back(uint8_t(c));
+    std::fclose(fd);
+    return data;
+  }
+}
+
+int main(){
+  const std::string direct = "test_direct_io.raw";
+  const std::string stdio = "test_direct_io_stdio.raw";
+
+  // writes smaller and larger than the buffers, ending off the alignment
+  std::vector<uint8_t> data;
+  std::vector<size_t> sizes = {1, 4095, 4097, 3, 20001, 7, 8192, 12345};
+  uint32_t crc_direct = 0;
+  uint32_t crc_stdio = 0;
+  for(auto &io: {std::string("direct"), std::string("stdio")}){
+    eudaq::FileSerializer ser(io == "direct" ? direct : stdio, true, io, 8192);
+    ser.ResetCheckSum();
+    uint8_t v = 0;
+    for(auto n: sizes){
+      std::vector<uint8_t> block(n);
+      for(auto &b: block)
+	b = v++ * 7 + 1;
+      ser.append(&block[0], n);
+      if(io == "direct")
+	data.insert(data.end(), block.begin(), block.end());
+    }
+    EUDAQ_CHECK(ser.FileBytes() == data.size());
+    (io == "direct" ? crc_direct : crc_stdio) = ser.GetCheckSum();
+  }
+  EUDAQ_CHECK(data.size() % 2 == 1);
+  // the padding of the last buffer is cut off
+  EUDAQ_CHECK(ReadAll(direct) == data);
+  EUDAQ_CHECK(ReadAll(stdio) == data);
+  EUDAQ_CHECK(crc_direct == crc_stdio);
+
+  // a native file written through it reads back with its footer
+  std::remove("test_direct_io_native.raw");
+  {
+    auto fw = eudaq::FileWriter::Make("native", "test_direct_io_native$X");
+    fw->SetConfiguration(std::make_shared<eudaq::Configuration>("EUDAQ_FW_IO = direct\n"
+								 "EUDAQ_FW_IO_BUFFER_MB = 1"));
+    for(uint32_t i = 0; i < 100; i++){
+      auto ev = eudaq::Event::MakeShared("TestRaw");
+      ev->SetEventN(i);
+      ev->AddBlock(0, std::vector<uint8_t>(i * 101, uint8_t(i)));
+      fw->WriteEvent(ev);
+    }
+  }
+  eudaq::NativeFileIndex idx;
+  EUDAQ_CHECK(eudaq::NativeFileIndex::ReadFooter("test_direct_io_native.raw", idx));
+  EUDAQ_CHECK(idx.NumEvents() == 100);
+  eudaq::FileDeserializer des("test_direct_io_native.raw");
+  for(uint32_t i = 0; i < 100; i++){
+    auto ev = des.ReadEvent();
+    EUDAQ_CHECK(ev && ev->GetEventN() == i);
+    EUDAQ_CHECK(ev->GetBlock(0) == std::vector<uint8_t>(i * 101, uint8_t(i)));
+  }
+  EUDAQ_CHECK(!des.ReadEvent());
+  return 0;
+}
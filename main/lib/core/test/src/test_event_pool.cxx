@@ -0,0 +1,45 @@
+#include "eudaq/EventPool.hh"
+#include "eudaq/Utils.hh"
+#include "TestCheck.hh"
+
+#include <vector>
+
+int main(){
+  const eudaq::Event *first = nullptr;
+  eudaq::EventSP late;
+  {
+    eudaq::EventPool pool("TestRaw", 2);
+    EUDAQ_CHECK(pool.NumFree() == 0);
+    auto ev = pool.MakeShared();
+    EUDAQ_CHECK(ev->GetDescription() == "TestRaw");
+    EUDAQ_CHECK(ev->GetExtendWord() == eudaq::str2hash("TestRaw"));
+    ev->SetEventN(42);
+    ev->SetTag("key", "value");
+    ev->AddBlock(0, std::vector<uint8_t>(100, 1));
+    first = ev.get();
+    ev.reset();
+    EUDAQ_CHECK(pool.NumFree() == 1);
+
+    // the same object comes back, emptied, with its description
+    auto again = pool.MakeUnique();
+    EUDAQ_CHECK(again.get() == first);
+    EUDAQ_CHECK(again->GetEventN() == 0);
+    EUDAQ_CHECK(again->GetTags().empty());
+    EUDAQ_CHECK(again->NumBlocks() == 0);
+    EUDAQ_CHECK(again->GetDescription() == "TestRaw");
+    EUDAQ_CHECK(pool.NumFree() == 0);
+
+    // no more than max_free events are kept
+    std::vector<eudaq::EventSP> evs;
+    for(int i = 0; i < 5; i++)
+      evs.push_back(pool.MakeShared());
+    evs.clear();
+    EUDAQ_CHECK(pool.NumFree() == 2);
+
+    // an event may outlive its pool
+    late = pool.MakeShared();
+  }
+  late->SetEventN(1);
+  late.reset();
+  return 0;
+}
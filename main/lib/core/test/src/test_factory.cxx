@@ -0,0 +1,92 @@
+#include "eudaq/Factory.hh"
+#include "eudaq/Event.hh"
+#include "eudaq/BufferSerializer.hh"
+#include "eudaq/Utils.hh"
+#include "TestCheck.hh"
+
+#include <vector>
+
+namespace{
+  class Shape{
+  public:
+    virtual ~Shape(){}
+    virtual int Size() const = 0;
+  };
+
+  class Square: public Shape{
+  public:
+    Square():m_size(1){}
+    Square(int &&size):m_size(size){}
+    int Size() const override {return m_size;}
+  private:
+    int m_size;
+  };
+
+  template <int N>
+  class Fixed: public Shape{
+  public:
+    int Size() const override {return N;}
+  };
+
+  using ShapeFactory = eudaq::Factory<Shape>;
+
+  auto dummy0 = ShapeFactory::Register<Square>(eudaq::cstr2hash("Square"));
+  auto dummy1 = ShapeFactory::Register<Square, int&&>(eudaq::cstr2hash("Square"));
+
+  template <int N>
+  void RegisterFixed(){
+    ShapeFactory::Register<Fixed<N>>(1000 + N);
+    RegisterFixed<N - 1>();
+  }
+  template <>
+  void RegisterFixed<0>(){}
+}
+
+int main(){
+  const uint32_t square_id = eudaq::cstr2hash("Square");
+  EUDAQ_CHECK(ShapeFactory::MakeUnique(square_id)->Size() == 1);
+  EUDAQ_CHECK(ShapeFactory::MakeUnique<int&&>(square_id, 4)->Size() == 4);
+  EUDAQ_CHECK(ShapeFactory::MakeShared<int&&>(square_id, 5)->Size() == 5);
+  EUDAQ_CHECK(!ShapeFactory::MakeUnique(eudaq::cstr2hash("Circle")));
+  EUDAQ_CHECK(!ShapeFactory::Find<>(eudaq::cstr2hash("Circle")));
+
+  // the plain product has the default deleter
+  ShapeFactory::UP_PLAIN plain = ShapeFactory::MakePlain<int&&>(square_id, 6);
+  EUDAQ_CHECK(plain && plain->Size() == 6);
+  EUDAQ_CHECK(!ShapeFactory::MakePlain(eudaq::cstr2hash("Circle")));
+
+  ShapeFactory::Handle<> square(square_id);
+  EUDAQ_CHECK(square()->Size() == 1);
+  ShapeFactory::Handle<> unknown(eudaq::cstr2hash("Circle"));
+  EUDAQ_CHECK(!unknown());
+
+  // registered after the lookup table was built, as a module loaded late
+  RegisterFixed<64>();
+  for(int n = 1; n <= 64; n++){
+    EUDAQ_CHECK(ShapeFactory::Find<>(1000 + n));
+    EUDAQ_CHECK(ShapeFactory::MakeUnique(1000 + n)->Size() == n);
+    EUDAQ_CHECK(ShapeFactory::MakePlain(1000 + n)->Size() == n);
+  }
+  EUDAQ_CHECK(!ShapeFactory::Find<>(1000));
+  EUDAQ_CHECK(square()->Size() == 1);
+
+  // a description hash computed once gives the same event
+  static constexpr uint32_t dspt_hash = eudaq::cstr2hash("TestRaw");
+  auto ev = eudaq::Event::MakeUnique("TestRaw", dspt_hash);
+  EUDAQ_CHECK(ev->GetExtendWord() == eudaq::Event::MakeUnique("TestRaw")->GetExtendWord());
+  EUDAQ_CHECK(ev->GetDescription() == "TestRaw");
+
+  // and deserializes through the plain maker
+  ev->SetEventN(17);
+  ev->AddBlock(3, std::vector<uint8_t>{1, 2, 3});
+  eudaq::BufferSerializer ser;
+  ev->Serialize(ser);
+  uint32_t id;
+  ser.PreRead(id);
+  eudaq::EventSP back = eudaq::Factory<eudaq::Event>::MakePlain<eudaq::Deserializer&>(id, ser);
+  EUDAQ_CHECK(back);
+  EUDAQ_CHECK(back->GetEventN() == 17);
+  EUDAQ_CHECK(back->GetDescription() == "TestRaw");
+  EUDAQ_CHECK(back->GetBlock(3) == std::vector<uint8_t>({1, 2, 3}));
+  return 0;
+}
@@ -0,0 +1,71 @@
+#include "eudaq/LatencyTracer.hh"
+#include "TestCheck.hh"
+
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using eudaq::LatencyTracer;
+
+namespace{
+  const std::string WRITE_TAG = "Trace.FileWriter::WriteEvent";
+
+  void TraceFromThreads(size_t n_thread, uint32_t n_ev){
+    std::vector<std::thread> ths;
+    for(size_t i = 0; i < n_thread; i++)
+      ths.emplace_back([n_ev](){
+	  for(uint32_t ev_n = 0; ev_n < n_ev; ev_n++)
+	    eudaq::LatencyTraceScope trace(LatencyTracer::STAGE_FILE_WRITE, ev_n);
+	});
+    for(auto &th: ths)
+      th.join();
+  }
+}
+
+int main(){
+  auto &tracer = LatencyTracer::Instance();
+
+  // nothing is recorded while disabled
+  TraceFromThreads(2, 10);
+  EUDAQ_CHECK(tracer.GetSummary().empty());
+
+  tracer.SetEnabled(true);
+  TraceFromThreads(4, 100);
+  auto tags = tracer.GetSummary();
+  EUDAQ_CHECK(tags.count(WRITE_TAG));
+  EUDAQ_CHECK(tags[WRITE_TAG].find("n=400 ") == 0);
+
+  // the records of threads that are gone are still written out
+  tracer.WriteChromeTrace("test_latency_tracer.json");
+  std::ifstream file("test_latency_tracer.json");
+  std::stringstream json;
+  json << file.rdbuf();
+  EUDAQ_CHECK(json.str().find("\"EventN\":99") != std::string::npos);
+
+  tracer.Reset();
+  EUDAQ_CHECK(tracer.GetSummary().empty());
+
+  // threads come and go between the summaries; their rings are dropped
+  // once drained, the counts stay
+  for(int i = 0; i < 50; i++){
+    TraceFromThreads(2, 5);
+    tracer.GetSummary();
+  }
+  tags = tracer.GetSummary();
+  EUDAQ_CHECK(tags[WRITE_TAG].find("n=500 ") == 0);
+
+  // the event number may be known only inside the scope
+  tracer.Reset();
+  {
+    eudaq::LatencyTraceScope trace(LatencyTracer::STAGE_MONITOR_RECEIVE);
+    trace.SetEventN(7);
+  }
+  tracer.WriteChromeTrace("test_latency_tracer.json");
+  std::ifstream file2("test_latency_tracer.json");
+  std::stringstream json2;
+  json2 << file2.rdbuf();
+  EUDAQ_CHECK(json2.str().find("\"EventN\":7}") != std::string::npos);
+  EUDAQ_CHECK(json2.str().find("Monitor::OnReceive") != std::string::npos);
+  return 0;
+}
@@ -0,0 +1,41 @@
+#include "eudaq/Metrics.hh"
+#include "TestCheck.hh"
+
+int main(){
+  eudaq::MetricRegistry reg(10.);
+  auto &events = reg.Counter("Events");
+  auto &bytes = reg.Counter("FileBytes", "B");
+  auto &depth = reg.Gauge("QueueDepth");
+
+  // a name always gives the same metric
+  EUDAQ_CHECK(&reg.Counter("Events") == &events);
+  EUDAQ_CHECK(&reg.Gauge("QueueDepth") == &depth);
+  EUDAQ_CHECK(bytes.Unit() == "B");
+
+  events.Add();
+  events.Add(9);
+  bytes.Add(1 << 20);
+  depth.Set(5);
+  depth.Add(-2);
+  EUDAQ_CHECK(events.Get() == 10);
+  EUDAQ_CHECK(depth.Get() == 3);
+
+  auto tags = reg.GetStatusTags();
+  EUDAQ_CHECK(tags["Events"] == "10");
+  EUDAQ_CHECK(tags["FileBytes"] == std::to_string(1 << 20));
+  EUDAQ_CHECK(tags["QueueDepth"] == "3");
+  EUDAQ_CHECK(tags.count("EventsRate"));
+  EUDAQ_CHECK(tags["FileBytesRate"].find("MB/s") != std::string::npos);
+
+  std::string text = reg.GetPrometheusText("run=\"1\"");
+  EUDAQ_CHECK(text.find("eudaq_events") != std::string::npos);
+  EUDAQ_CHECK(text.find("eudaq_queuedepth{run=\"1\"} 3") != std::string::npos);
+
+  // a new run starts from zero with the same metric objects
+  reg.Reset();
+  EUDAQ_CHECK(events.Get() == 0);
+  EUDAQ_CHECK(depth.Get() == 0);
+  events.Add(3);
+  EUDAQ_CHECK(reg.GetStatusTags()["Events"] == "3");
+  return 0;
+}
@@ -0,0 +1,110 @@
+#include "eudaq/FileWriter.hh"
+#include "eudaq/FileReader.hh"
+#include "eudaq/FileDeserializer.hh"
+#include "eudaq/NativeFileIndex.hh"
+#include "TestCheck.hh"
+
+#include <cstdio>
+#include <vector>
+
+namespace{
+  const uint32_t N_EV = 350;
+
+  std::string ChunkPath(uint32_t n){
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), "test_native_chunks_%04u.raw", n);
+    return buf;
+  }
+
+  uint64_t FileSize(const std::string &path){
+    eudaq::FileDeserializer des(path);
+    return des.FileSize();
+  }
+
+  uint32_t NextEventN(eudaq::FileReaderSP fr){
+    auto ev = fr->GetNextEvent();
+    EUDAQ_CHECK(ev);
+    return ev->GetEventN();
+  }
+}
+
+int main(){
+  for(uint32_t n = 0; n < 6; n++)
+    std::remove(ChunkPath(n).c_str());
+
+  {
+    auto fw = eudaq::FileWriter::Make("native", "test_native_chunks$X");
+    fw->SetConfiguration(std::make_shared<eudaq::Configuration>("EUDAQ_FW_CHUNK_EVENTS = 100"));
+    uint64_t bytes = 0;
+    for(uint32_t i = 0; i < N_EV; i++){
+      auto ev = eudaq::Event::MakeShared("TestRaw");
+      ev->SetRunN(1);
+      ev->SetEventN(i);
+      ev->AddBlock(0, std::vector<uint8_t>(i % 50, uint8_t(i)));
+      fw->WriteEvent(ev);
+      // counts the run, not only the open chunk
+      EUDAQ_CHECK(fw->FileBytes() > bytes);
+      bytes = fw->FileBytes();
+    }
+    uint64_t on_disk = 0;
+    for(uint32_t n = 0; n < 4; n++)
+      on_disk += FileSize(ChunkPath(n));
+    EUDAQ_CHECK(bytes == on_disk);
+  }
+
+  // every chunk holds the index of its own events
+  for(uint32_t n = 0; n < 4; n++){
+    eudaq::NativeFileIndex idx;
+    EUDAQ_CHECK(eudaq::NativeFileIndex::ReadFooter(ChunkPath(n), idx));
+    EUDAQ_CHECK(idx.NumEvents() == (n < 3 ? 100 : 50));
+    EUDAQ_CHECK(idx.m_ev_first == n * 100);
+    EUDAQ_CHECK(idx.m_ev_last == n * 100 + idx.NumEvents() - 1);
+    // the frame of the first event follows the magic and version words
+    EUDAQ_CHECK(idx.m_offsets[0] == 2 * sizeof(uint32_t));
+    eudaq::FileDeserializer des(ChunkPath(n));
+    des.Seek(idx.m_offsets.back());
+    auto ev = des.ReadEvent();
+    EUDAQ_CHECK(ev && ev->GetEventN() == idx.m_ev_last);
+  }
+  {
+    FILE *fd = std::fopen(ChunkPath(4).c_str(), "rb");
+    EUDAQ_CHECK(!fd);
+  }
+
+  // all the events in order
+  {
+    auto fr = eudaq::FileReader::Make("nativechunk", ChunkPath(0));
+    for(uint32_t i = 0; i < N_EV; i++)
+      EUDAQ_CHECK(NextEventN(fr) == i);
+    EUDAQ_CHECK(!fr->GetNextEvent());
+  }
+
+  // skips pending on a chunk add up
+  {
+    auto fr = eudaq::FileReader::Make("nativechunk", ChunkPath(0));
+    EUDAQ_CHECK(fr->SkipEvents(30) == 30);
+    EUDAQ_CHECK(fr->SkipEvents(30) == 30);
+    EUDAQ_CHECK(NextEventN(fr) == 60);
+  }
+
+  // and carry over into the next chunks
+  {
+    auto fr = eudaq::FileReader::Make("nativechunk", ChunkPath(0));
+    EUDAQ_CHECK(fr->SkipEvents(90) == 90);
+    EUDAQ_CHECK(fr->SkipEvents(20) == 20);
+    EUDAQ_CHECK(fr->SkipEvents(150) == 150);
+    EUDAQ_CHECK(NextEventN(fr) == 260);
+    // once reading, the rest is skipped event by event
+    EUDAQ_CHECK(fr->SkipEvents(10) == 10);
+    EUDAQ_CHECK(NextEventN(fr) == 271);
+    EUDAQ_CHECK(fr->SkipEvents(1000) == N_EV - 272);
+    EUDAQ_CHECK(!fr->GetNextEvent());
+  }
+
+  // a reader may be dropped with its threads still reading
+  {
+    auto fr = eudaq::FileReader::Make("nativechunk", ChunkPath(0));
+    EUDAQ_CHECK(NextEventN(fr) == 0);
+  }
+  return 0;
+}
@@ -0,0 +1,116 @@
+#include "eudaq/FileWriter.hh"
+#include "eudaq/FileReader.hh"
+#include "eudaq/FileSerializer.hh"
+#include "eudaq/FileDeserializer.hh"
+#include "eudaq/NativeFileIndex.hh"
+#include "TestCheck.hh"
+
+#include <cstdio>
+#include <vector>
+
+namespace{
+  const uint32_t N_EV = 50;
+
+  // event i carries i*37 bytes of i, event 10 more than the read buffer
+  eudaq::EventSP MakeEvent(uint32_t i){
+    auto ev = eudaq::Event::MakeShared("TestRaw");
+    ev->SetRunN(1);
+    ev->SetEventN(i);
+    size_t n = i == 10 ? 200000 : i * 37;
+    ev->AddBlock(0, std::vector<uint8_t>(n, uint8_t(i)));
+    return ev;
+  }
+
+  void CheckEvent(const eudaq::EventSPC &ev, uint32_t i){
+    EUDAQ_CHECK(ev);
+    EUDAQ_CHECK(ev->GetEventN() == i);
+    EUDAQ_CHECK(ev->GetDescription() == "TestRaw");
+    EUDAQ_CHECK(ev->GetBlock(0) == MakeEvent(i)->GetBlock(0));
+  }
+}
+
+int main(){
+  const std::string framed = "test_native_format.raw";
+  const std::string plain = "test_native_format_plain.raw";
+  std::remove(framed.c_str());
+  std::remove(plain.c_str());
+
+  {
+    auto fw = eudaq::FileWriter::Make("native", "test_native_format$X");
+    fw->SetConfiguration(std::make_shared<eudaq::Configuration>());
+    for(uint32_t i = 0; i < N_EV; i++)
+      fw->WriteEvent(MakeEvent(i));
+  }
+
+  // headers of every event, the footer passed over
+  {
+    eudaq::FileDeserializer des(framed);
+    EUDAQ_CHECK(des.IsFramed());
+    EUDAQ_CHECK(des.FormatVersion() == eudaq::NATIVE_FILE_VERSION);
+    eudaq::EventHeader h;
+    uint32_t n = 0;
+    while(des.ReadHeader(h)){
+      EUDAQ_CHECK(h.ev_n == n);
+      EUDAQ_CHECK(h.run_n == 1);
+      EUDAQ_CHECK(h.dspt == "TestRaw");
+      EUDAQ_CHECK(h.n_block == 1);
+      EUDAQ_CHECK(h.block_bytes == MakeEvent(n)->GetBlock(0).size());
+      n++;
+    }
+    EUDAQ_CHECK(n == N_EV);
+    EUDAQ_CHECK(des.Tell() == des.FileSize());
+  }
+
+  // skipping lands on the event after
+  {
+    eudaq::FileDeserializer des(framed);
+    for(uint32_t i = 0; i < 25; i++)
+      EUDAQ_CHECK(des.SkipEvent());
+    CheckEvent(des.ReadEvent(), 25);
+  }
+
+  // the index of the footer points at every event
+  {
+    eudaq::NativeFileIndex idx;
+    EUDAQ_CHECK(eudaq::NativeFileIndex::ReadFooter(framed, idx));
+    EUDAQ_CHECK(idx.NumEvents() == N_EV);
+    EUDAQ_CHECK(idx.m_ev_first == 0);
+    EUDAQ_CHECK(idx.m_ev_last == N_EV - 1);
+    EUDAQ_CHECK(idx.m_streams["TestRaw"][0] == N_EV);
+    eudaq::FileDeserializer des(framed);
+    for(uint32_t i = N_EV; i-- > 0;){
+      des.Seek(idx.m_offsets[i]);
+      EUDAQ_CHECK(des.Tell() == idx.m_offsets[i]);
+      CheckEvent(des.ReadEvent(), i);
+    }
+  }
+
+  // and the reader gives them all back
+  {
+    auto fr = eudaq::FileReader::Make("native", framed);
+    for(uint32_t i = 0; i < N_EV; i++)
+      CheckEvent(fr->GetNextEvent(), i);
+    EUDAQ_CHECK(!fr->GetNextEvent());
+  }
+
+  // files of plain events stay readable
+  {
+    eudaq::FileSerializer ser(plain);
+    for(uint32_t i = 0; i < N_EV; i++)
+      ser.write(*MakeEvent(i));
+  }
+  {
+    eudaq::FileDeserializer des(plain);
+    EUDAQ_CHECK(!des.IsFramed());
+    EUDAQ_CHECK(des.FormatVersion() == 0);
+    for(uint32_t i = 0; i < 5; i++)
+      EUDAQ_CHECK(des.SkipEvent());
+    eudaq::EventHeader h;
+    EUDAQ_CHECK(des.ReadHeader(h));
+    EUDAQ_CHECK(h.ev_n == 5);
+    for(uint32_t i = 6; i < N_EV; i++)
+      CheckEvent(des.ReadEvent(), i);
+    EUDAQ_CHECK(!des.ReadEvent());
+  }
+  return 0;
+}
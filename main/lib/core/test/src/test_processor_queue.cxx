@@ -0,0 +1,120 @@
+#include "eudaq/Processor.hh"
+#include "eudaq/TaskPool.hh"
+#include "TestCheck.hh"
+
+#include <atomic>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace{
+  // records the event numbers it is given, optionally held at a gate
+  class RecordPS: public eudaq::Processor{
+  public:
+    RecordPS():Processor("RecordPS"), m_open(true), m_busy(0), m_max_busy(0){}
+    void ProcessEvent(eudaq::EventSPC ev) override {
+      int busy = ++m_busy;
+      if(busy > m_max_busy)
+	m_max_busy = busy;
+      while(!m_open)
+	std::this_thread::yield();
+      {
+	std::lock_guard<std::mutex> lk(m_mtx);
+	m_ev_n.push_back(ev->GetEventN());
+      }
+      m_busy--;
+    }
+    std::mutex m_mtx;
+    std::vector<uint32_t> m_ev_n;
+    std::atomic_bool m_open;
+    std::atomic<int> m_busy;
+    std::atomic<int> m_max_busy;
+  };
+
+  eudaq::EventSPC MakeEvent(uint32_t ev_n){
+    auto ev = eudaq::Event::MakeShared("TestRaw");
+    ev->SetEventN(ev_n);
+    return ev;
+  }
+
+  // the number in <tag> n </tag> of the Print output
+  uint64_t Printed(const eudaq::ProcessorSP &ps, const std::string &tag){
+    std::ostringstream os;
+    ps->Print(os);
+    std::string s = os.str();
+    size_t pos = s.find("<" + tag + "> ");
+    EUDAQ_CHECK(pos != std::string::npos);
+    return std::stoull(s.substr(pos + tag.size() + 3));
+  }
+}
+
+int main(){
+  auto &pool = eudaq::TaskPool::Instance();
+
+  // by default one event at a time, in arrival order
+  {
+    auto ps = std::make_shared<RecordPS>();
+    for(uint32_t i = 0; i < 2000; i++)
+      ps->RegisterEvent(MakeEvent(i));
+    pool.WaitIdle();
+    EUDAQ_CHECK(ps->m_ev_n.size() == 2000);
+    for(uint32_t i = 0; i < 2000; i++)
+      EUDAQ_CHECK(ps->m_ev_n[i] == i);
+    EUDAQ_CHECK(ps->m_max_busy == 1);
+  }
+
+  // opted out of ordering, every event still arrives once
+  {
+    auto ps = std::make_shared<RecordPS>();
+    *ps << "SYS:OD:OFF";
+    std::vector<std::thread> ths;
+    for(uint32_t t = 0; t < 4; t++)
+      ths.emplace_back([ps, t](){
+	  for(uint32_t i = 0; i < 500; i++)
+	    ps->RegisterEvent(MakeEvent(t * 500 + i));
+	});
+    for(auto &th: ths)
+      th.join();
+    pool.WaitIdle();
+    EUDAQ_CHECK(ps->m_ev_n.size() == 2000);
+  }
+
+  // a full queue drops with the drop policy
+  {
+    auto ps = std::make_shared<RecordPS>();
+    *ps << "SYS:QU:SIZE=4" << "SYS:QU:POLICY=drop";
+    ps->m_open = false;
+    for(uint32_t i = 0; i < 100; i++)
+      ps->RegisterEvent(MakeEvent(i));
+    uint64_t accepted = Printed(ps, "Accepted");
+    uint64_t dropped = Printed(ps, "Dropped");
+    EUDAQ_CHECK(accepted + dropped == 100);
+    EUDAQ_CHECK(dropped > 0);
+    EUDAQ_CHECK(Printed(ps, "MaxDepth") <= 4);
+    ps->m_open = true;
+    pool.WaitIdle();
+    EUDAQ_CHECK(ps->m_ev_n.size() == accepted);
+    EUDAQ_CHECK(Printed(ps, "Processed") == accepted);
+  }
+
+  // and holds the upstream back with the block policy, losing nothing
+  {
+    auto ps = std::make_shared<RecordPS>();
+    *ps << "SYS:QU:SIZE=4" << "SYS:QU:POLICY=block";
+    ps->m_open = false;
+    std::thread th([ps](){
+	for(uint32_t i = 0; i < 100; i++)
+	  ps->RegisterEvent(MakeEvent(i));
+      });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EUDAQ_CHECK(Printed(ps, "Accepted") < 100);
+    ps->m_open = true;
+    th.join();
+    pool.WaitIdle();
+    EUDAQ_CHECK(ps->m_ev_n.size() == 100);
+    EUDAQ_CHECK(Printed(ps, "Dropped") == 0);
+    EUDAQ_CHECK(Printed(ps, "MaxDepth") <= 5);
+  }
+  return 0;
+}
@@ -0,0 +1,75 @@
+#include "eudaq/TaskPool.hh"
+#include "TestCheck.hh"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+int main(){
+  // every task runs once, also those submitted by other tasks
+  {
+    eudaq::TaskPool pool(4);
+    EUDAQ_CHECK(pool.GetNumWorkers() == 4);
+    std::atomic<int> n_run(0);
+    for(int i = 0; i < 1000; i++)
+      pool.Submit([&](){
+	  n_run++;
+	  if(n_run % 10 == 0)
+	    pool.Submit([&](){n_run += 1000;});
+	});
+    pool.WaitIdle();
+    EUDAQ_CHECK(n_run == 1000 + 100 * 1000);
+    pool.WaitIdle();
+  }
+
+  // a pool is idle right away and can be destroyed with nothing to do
+  {
+    eudaq::TaskPool pool(2);
+    pool.WaitIdle();
+  }
+
+  // the items of each producer come out in the order they were pushed
+  {
+    const int n_thread = 4;
+    const int n_item = 20000;
+    eudaq::MpscQueue<std::pair<int, int>> que;
+    std::vector<std::thread> ths;
+    for(int t = 0; t < n_thread; t++)
+      ths.emplace_back([&que, t](){
+	  for(int i = 0; i < n_item; i++)
+	    que.Push(std::make_pair(t, i));
+	});
+    std::vector<int> next(n_thread, 0);
+    int n_pop = 0;
+    std::pair<int, int> item;
+    while(n_pop < n_thread * n_item){
+      if(!que.Pop(item)){
+	std::this_thread::yield();
+	continue;
+      }
+      EUDAQ_CHECK(item.second == next[item.first]);
+      next[item.first]++;
+      n_pop++;
+    }
+    for(auto &th: ths)
+      th.join();
+    EUDAQ_CHECK(!que.Pop(item));
+    EUDAQ_CHECK(que.Size() == 0);
+  }
+
+  // the queue frees what was never popped
+  std::weak_ptr<int> w;
+  {
+    eudaq::MpscQueue<std::shared_ptr<int>> que;
+    auto p = std::make_shared<int>(1);
+    w = p;
+    que.Push(p);
+    que.Push(p);
+    EUDAQ_CHECK(que.Size() == 2);
+    p.reset();
+    EUDAQ_CHECK(!w.expired());
+  }
+  EUDAQ_CHECK(w.expired());
+  return 0;
+}
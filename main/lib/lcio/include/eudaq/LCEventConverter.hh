@@ -30,6 +30,9 @@ namespace eudaq{
     LCEventConverter& operator = (const LCEventConverter&) = delete;
     bool Converting(EventSPC d1, LCEventSP d2, ConfigurationSPC conf) const override = 0;
     static bool Convert(EventSPC d1, LCEventSP d2, ConfigurationSPC conf);
+    // converter for an event type, created once per thread and then reused;
+    // nullptr if there is none
+    static const LCEventConverter *GetConverter(uint32_t id);
     // static LCEventSP MakeSharedLCEvent(uint32_t run, uint32_t stm);
   };
 
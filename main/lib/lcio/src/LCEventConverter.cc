@@ -1,6 +1,10 @@
 #include "eudaq/LCEventConverter.hh"
 
 namespace eudaq{
+
+  namespace{
+    thread_local std::map<uint32_t, LCEventConverterUP> t_converters;
+  }
   
   template DLLEXPORT
   std::map<uint32_t, typename Factory<LCEventConverter>::UP(*)()>&
@@ -57,7 +61,7 @@ namespace eudaq{
     }
     
     uint32_t id = d1->GetType();
-    auto cvt = Factory<LCEventConverter>::MakeUnique(id);
+    auto cvt = GetConverter(id);
     if(cvt){
       return cvt->Converting(d1, d2, conf);
     }
@@ -66,4 +70,11 @@ namespace eudaq{
       return false;
     }
   }
+
+  const LCEventConverter *LCEventConverter::GetConverter(uint32_t id){
+    auto it = t_converters.find(id);
+    if(it == t_converters.end())
+      it = t_converters.emplace(id, Factory<LCEventConverter>::MakeUnique(id)).first;
+    return it->second.get();
+  }
 }
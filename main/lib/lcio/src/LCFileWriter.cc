@@ -2,9 +2,14 @@
 #include "eudaq/FileWriter.hh"
 #include "eudaq/Configuration.hh"
 #include "eudaq/LCEventConverter.hh"
+#include "eudaq/TaskPool.hh"
 #include <ostream>
 #include <ctime>
 #include <iomanip>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 
 #include "lcio.h"
@@ -23,41 +28,159 @@ namespace eudaq {
     auto dummy11 = Factory<FileWriter>::Register<LCFileWriter, std::string&&>(cstr2hash("slcio"));
   }
 
+  // Converts on the shared TaskPool, several events at a time, and writes
+  // the converted events in their original order on its own I/O thread.
   class LCFileWriter : public FileWriter {
   public:
     LCFileWriter(const std::string &patt);
+    ~LCFileWriter() override;
     void WriteEvent(EventSPC ev) override;
   private:
+    struct Converted {
+      uint32_t run_n;
+      LCEventSP lcevent;
+    };
+    void Converting(EventSPC ev, uint64_t seq, ConfigurationSPC conf);
+    void Writing();
+    void OpenFile(uint32_t run_n);
+    void CloseFile();
+
     std::unique_ptr<lcio::LCWriter> m_lcwriter;
     std::string m_filepattern;
     uint32_t m_run_n;
+
+    uint64_t m_max_flight;
+    std::thread m_th_write;
+    std::mutex m_mtx;
+    std::condition_variable m_cv_done;
+    std::condition_variable m_cv_space;
+    std::map<uint64_t, Converted> m_done;
+    uint64_t m_seq_in;
+    uint64_t m_seq_out;
+    bool m_exit;
+    // a failure to write the LCIO file, reported to every later WriteEvent
+    std::string m_error;
   };
 
-  LCFileWriter::LCFileWriter(const std::string &patt){
-    m_filepattern = patt;
+  LCFileWriter::LCFileWriter(const std::string &patt)
+    :m_filepattern(patt), m_run_n(0), m_max_flight(0), m_seq_in(0), m_seq_out(0),
+     m_exit(false){
+    m_th_write = std::thread(&LCFileWriter::Writing, this);
+  }
+
+  LCFileWriter::~LCFileWriter(){
+    {
+      std::lock_guard<std::mutex> lk(m_mtx);
+      m_exit = true;
+    }
+    m_cv_done.notify_all();
+    if(m_th_write.joinable())
+      m_th_write.join();
   }
 
   void LCFileWriter::WriteEvent(EventSPC ev) {
-    uint32_t run_n = ev->GetRunN();
-    if(!m_lcwriter || m_run_n != run_n){
-      try {
-	m_lcwriter.reset(lcio::LCFactory::getInstance()->createLCWriter());
-	std::time_t time_now = std::time(nullptr);
-	char time_buff[13];
-	time_buff[12] = 0;
-	std::strftime(time_buff, sizeof(time_buff), "%y%m%d%H%M%S", std::localtime(&time_now));
-	std::string time_str(time_buff);
-	m_lcwriter->open(FileNamer(m_filepattern).Set('R', run_n).Set('D', time_str),
-			 lcio::LCIO::WRITE_NEW);
-	m_run_n = run_n;
-      } catch (const lcio::IOException &e) {
-	EUDAQ_THROW(std::string("Fail to open LCIO file")+e.what());
+    auto conf = GetConfiguration();
+    std::unique_lock<std::mutex> lk(m_mtx);
+    if(!m_max_flight){
+      m_max_flight = 4 * TaskPool::Instance().GetNumWorkers();
+      if(conf)
+	m_max_flight = conf->Get("EUDAQ_LCIO_QUEUE", m_max_flight);
+      if(!m_max_flight)
+	m_max_flight = 1;
+    }
+    m_cv_space.wait(lk, [this](){return m_seq_in - m_seq_out < m_max_flight || !m_error.empty();});
+    if(!m_error.empty())
+      EUDAQ_THROW("LCFileWriter: "+m_error);
+    uint64_t seq = m_seq_in++;
+    lk.unlock();
+    TaskPool::Instance().Submit([this, ev, seq, conf](){Converting(ev, seq, conf);});
+  }
+
+  void LCFileWriter::Converting(EventSPC ev, uint64_t seq, ConfigurationSPC conf){
+    Converted cv{ev->GetRunN(), nullptr};
+    // an event that fails to convert is reported and left out, the writing
+    // thread passes over its empty slot; nothing may escape a pool task
+    try{
+      cv.lcevent.reset(new lcio::LCEventImpl);
+      LCEventConverter::Convert(ev, cv.lcevent, conf);
+    }
+    catch(const std::exception &e){
+      EUDAQ_ERROR(std::string("LCFileWriter: fail to convert event ") +
+		  std::to_string(ev->GetEventN()) + ": " + e.what());
+      cv.lcevent.reset();
+    }
+    catch(...){
+      EUDAQ_ERROR("LCFileWriter: fail to convert event " +
+		  std::to_string(ev->GetEventN()) + ": unknown exception");
+      cv.lcevent.reset();
+    }
+    std::lock_guard<std::mutex> lk(m_mtx);
+    m_done[seq] = std::move(cv);
+    m_cv_done.notify_all();
+  }
+
+  void LCFileWriter::Writing(){
+    std::unique_lock<std::mutex> lk(m_mtx);
+    while(true){
+      m_cv_done.wait(lk, [this](){return m_done.count(m_seq_out) || (m_exit && m_seq_out == m_seq_in);});
+      auto it = m_done.find(m_seq_out);
+      if(it == m_done.end())
+	break;
+      Converted cv = std::move(it->second);
+      m_done.erase(it);
+      lk.unlock();
+      std::string error;
+      try{
+	if(cv.lcevent){
+	  if(!m_lcwriter || m_run_n != cv.run_n)
+	    OpenFile(cv.run_n);
+	  m_lcwriter->writeEvent(cv.lcevent.get());
+	}
+      }
+      catch(const std::exception &e){
+	error = e.what();
       }
+      catch(...){
+	error = "unknown exception while writing";
+      }
+      cv.lcevent.reset();
+      lk.lock();
+      if(!error.empty() && m_error.empty())
+	m_error = error;
+      m_seq_out++;
+      m_cv_space.notify_all();
+    }
+    lk.unlock();
+    try{
+      CloseFile();
+    }
+    catch(const std::exception &e){
+      EUDAQ_ERROR(std::string("LCFileWriter: ")+e.what());
     }
+  }
+
+  void LCFileWriter::OpenFile(uint32_t run_n){
+    CloseFile();
+    try {
+      m_lcwriter.reset(lcio::LCFactory::getInstance()->createLCWriter());
+      std::time_t time_now = std::time(nullptr);
+      char time_buff[13];
+      time_buff[12] = 0;
+      std::strftime(time_buff, sizeof(time_buff), "%y%m%d%H%M%S", std::localtime(&time_now));
+      std::string time_str(time_buff);
+      m_lcwriter->open(FileNamer(m_filepattern).Set('R', run_n).Set('D', time_str),
+		       lcio::LCIO::WRITE_NEW);
+      m_run_n = run_n;
+    } catch (const lcio::IOException &e) {
+      m_lcwriter.reset();
+      EUDAQ_THROW(std::string("Fail to open LCIO file")+e.what());
+    }
+  }
+
+  void LCFileWriter::CloseFile(){
     if(!m_lcwriter)
-      EUDAQ_THROW("LCFileWriter: Attempt to write unopened file");
-    LCEventSP lcevent(new lcio::LCEventImpl);
-    LCEventConverter::Convert(ev, lcevent, GetConfiguration());
-    m_lcwriter->writeEvent(lcevent.get());
+      return;
+    auto lcwriter = std::move(m_lcwriter);
+    lcwriter->close();
   }
 }
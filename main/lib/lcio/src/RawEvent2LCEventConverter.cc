@@ -21,7 +21,7 @@ namespace eudaq{
       return false;
     }
     uint32_t id = ev->GetExtendWord();
-    auto cvt = Factory<LCEventConverter>::MakeUnique(id);
+    auto cvt = GetConverter(id);
     if(cvt){
       cvt->Converting(d1, d2, conf);
       return true;
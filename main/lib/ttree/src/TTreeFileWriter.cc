@@ -1,16 +1,24 @@
 #include "eudaq/FileNamer.hh"
 #include "eudaq/FileWriter.hh"
 #include "eudaq/Configuration.hh"
-#include "eudaq/TTreeEventConverter.hh"
+#include "eudaq/Logger.hh"
+#include "eudaq/StandardEvent.hh"
+#include "eudaq/StdEventConverter.hh"
 #include <ostream>
 #include <ctime>
 #include <iomanip>
 #include <vector>
+#include <deque>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
 
-
+#include "TROOT.h"
 #include "TFile.h"
 #include "TTree.h"
-#include "TRandom.h"
+#include "TBranch.h"
 #include "TString.h"
 
 
@@ -21,57 +29,296 @@ namespace eudaq {
     auto dummy11 = Factory<FileWriter>::Register<TTreeFileWriter, std::string&&>(cstr2hash("root"));
   }
 
+  // Writes StandardEvents column by column: a tree "EventTree" with the
+  // event header as scalar branches and, per plane, the hits as vector
+  // branches plane<ID>_x, _y, _val and _frame. One file per run.
   class TTreeFileWriter : public FileWriter {
   public:
     TTreeFileWriter(const std::string &patt);
-    ~TTreeFileWriter();
+    ~TTreeFileWriter() override;
     void WriteEvent(EventSPC ev) override;
+    uint64_t FileBytes() const override;
   private:
-    std::unique_ptr<TFile> m_ttreewriter;
+    struct PlaneRow {
+      uint32_t id;
+      std::vector<float> x;
+      std::vector<float> y;
+      std::vector<float> val;
+      std::vector<uint16_t> frame;
+    };
+    struct Row {
+      uint32_t run_n;
+      uint32_t event_n;
+      uint32_t trigger_n;
+      uint32_t device_n;
+      uint32_t event_flag;
+      uint64_t ts_begin;
+      uint64_t ts_end;
+      size_t n_plane;
+      std::vector<PlaneRow> planes;
+    };
+    struct PlaneBranches {
+      std::vector<float> *x;
+      std::vector<float> *y;
+      std::vector<float> *val;
+      std::vector<uint16_t> *frame;
+    };
+    void FillRow(const Event &ev, const StandardEvent &stdev, Row &row);
+    void Writing();
+    void OpenFile(uint32_t run_n);
+    void CloseFile();
+    void WriteRow(Row &row);
+    PlaneBranches &GetPlaneBranches(uint32_t id);
+
     std::string m_filepattern;
+    int m_basket_size;
+    int m_compression;
+    size_t m_max_queue;
+    bool m_configured;
+    StdEventSP m_stdev;
+
+    std::unique_ptr<TFile> m_tfile;
+    TTree *m_ttree; // owned by m_tfile
     uint32_t m_run_n;
-    TFile *m_tfile; // book the pointer to a file (to store the otuput)
-    TTreeEventSP ttree;
-    };
+    Row m_row; // branch addresses of the header
+    std::map<uint32_t, PlaneBranches> m_plane_br;
+    std::map<uint32_t, PlaneRow> m_plane_buf;
+    std::atomic<uint64_t> m_file_bytes;
+
+    std::thread m_th_write;
+    std::mutex m_mtx_que;
+    std::condition_variable m_cv_que;
+    std::condition_variable m_cv_space;
+    std::deque<std::unique_ptr<Row>> m_que;
+    std::vector<std::unique_ptr<Row>> m_free;
+    bool m_exit;
+    std::string m_error;
+  };
+
+  TTreeFileWriter::TTreeFileWriter(const std::string &patt)
+    :m_filepattern(patt), m_basket_size(32000), m_compression(101),
+     m_max_queue(1024), m_configured(false), m_ttree(nullptr), m_run_n(0),
+     m_file_bytes(0), m_exit(false){
+    // the tree is filled on m_th_write
+    ROOT::EnableThreadSafety();
+    m_th_write = std::thread(&TTreeFileWriter::Writing, this);
+  }
+
+  TTreeFileWriter::~TTreeFileWriter(){
+    {
+      std::lock_guard<std::mutex> lk(m_mtx_que);
+      m_exit = true;
+    }
+    m_cv_que.notify_all();
+    if(m_th_write.joinable())
+      m_th_write.join();
+  }
+
+  void TTreeFileWriter::WriteEvent(EventSPC ev){
+    if(!m_configured){
+      auto conf = GetConfiguration();
+      if(conf){
+	m_basket_size = conf->Get("EUDAQ_TTREE_BASKET_SIZE", m_basket_size);
+	m_compression = conf->Get("EUDAQ_TTREE_COMPRESSION", m_compression);
+	m_max_queue = conf->Get("EUDAQ_TTREE_QUEUE", m_max_queue);
+	if(m_max_queue == 0){
+	  // nothing would ever fit in the queue
+	  EUDAQ_WARN("TTreeFileWriter: EUDAQ_TTREE_QUEUE=0, using 1");
+	  m_max_queue = 1;
+	}
+      }
+      m_configured = true;
+    }
+    auto stdev = std::dynamic_pointer_cast<const StandardEvent>(ev);
+    if(!stdev){
+      if(!m_stdev)
+	m_stdev = StandardEvent::MakeShared();
+      else
+	m_stdev->Recycle();
+      if(!StdEventConverter::Convert(ev, m_stdev, GetConfiguration()))
+	return;
+      stdev = m_stdev;
+    }
+
+    std::unique_ptr<Row> row;
+    {
+      std::unique_lock<std::mutex> lk(m_mtx_que);
+      if(!m_error.empty())
+	EUDAQ_THROW("TTreeFileWriter: "+m_error);
+      if(!m_free.empty()){
+	row = std::move(m_free.back());
+	m_free.pop_back();
+      }
+    }
+    if(!row)
+      row.reset(new Row);
+    FillRow(*ev, *stdev, *row);
+
+    std::unique_lock<std::mutex> lk(m_mtx_que);
+    m_cv_space.wait(lk, [this](){return m_que.size() < m_max_queue || !m_error.empty();});
+    m_que.push_back(std::move(row));
+    lk.unlock();
+    m_cv_que.notify_one();
+  }
 
-  TTreeFileWriter::TTreeFileWriter(const std::string &patt){
-    m_filepattern = patt;    
-	std::time_t time_now = std::time(nullptr);
-	char time_buff[13];
-	time_buff[12] = 0;
-	std::strftime(time_buff, sizeof(time_buff), "%y%m%d%H%M%S", std::localtime(&time_now));
-	std::string time_str(time_buff);
-	std::string foutput(FileNamer(m_filepattern).Set('X', ".root").Set('R', m_run_n).Set('D', time_str));
-	m_tfile = new TFile(foutput.c_str(), "RECREATE");
-	EUDAQ_INFO("Preparing the outputfile: " + foutput);
-	ttree.reset(new TTree("EventTree","Converted from .raw"));
-	TBranch* run   = ttree->Branch("run_n",0, "run_n/i");
-	TBranch* event = ttree->Branch("event_n",0, "event_n/i");
-	TBranch* eventflag = ttree->Branch("event_flag",0, "eflag/i");
-	TBranch* device_n = ttree->Branch("device_n",0, "devnum/i");	
-	TBranch* trigger_n = ttree->Branch("trigger_n",0, "trign/i");
-	TBranch* tsb = ttree->Branch("timestampbegin",0, "tsb/l");
-	TBranch* tse = ttree->Branch("timestampend",0, "tse/l");
+  uint64_t TTreeFileWriter::FileBytes() const {
+    return m_file_bytes;
   }
-  TTreeFileWriter::~TTreeFileWriter () {
-    m_tfile->Write();    
+
+  void TTreeFileWriter::FillRow(const Event &ev, const StandardEvent &stdev, Row &row){
+    row.run_n = ev.GetRunN();
+    row.event_n = ev.GetEventN();
+    row.trigger_n = ev.GetTriggerN();
+    row.device_n = ev.GetDeviceN();
+    row.event_flag = ev.GetFlag();
+    row.ts_begin = ev.GetTimestampBegin();
+    row.ts_end = ev.GetTimestampEnd();
+    row.n_plane = stdev.NumPlanes();
+    if(row.planes.size() < row.n_plane)
+      row.planes.resize(row.n_plane);
+    for(size_t i = 0; i < row.n_plane; i++){
+      const StandardPlane &plane = stdev.GetPlane(i);
+      PlaneRow &pr = row.planes[i];
+      pr.id = plane.ID();
+      pr.x.clear();
+      pr.y.clear();
+      pr.val.clear();
+      pr.frame.clear();
+      for(uint32_t f = 0; f < plane.NumFrames(); f++){
+	const std::vector<StandardPlane::coord_t> &x = plane.XVector(f);
+	const std::vector<StandardPlane::coord_t> &y = plane.YVector(f);
+	const std::vector<StandardPlane::pixel_t> &val = plane.PixVector(f);
+	pr.x.insert(pr.x.end(), x.begin(), x.end());
+	pr.y.insert(pr.y.end(), y.begin(), y.end());
+	pr.val.insert(pr.val.end(), val.begin(), val.end());
+	pr.frame.resize(pr.x.size(), f);
+      }
+    }
   }
-  
-  void TTreeFileWriter::WriteEvent(EventSPC ev) {
-    uint32_t run_n = ev->GetRunN();
-    if(!m_ttreewriter || m_run_n != run_n){
+
+  void TTreeFileWriter::Writing(){
+    std::unique_lock<std::mutex> lk(m_mtx_que);
+    while(true){
+      m_cv_que.wait(lk, [this](){return !m_que.empty() || m_exit;});
+      if(m_que.empty())
+	break;
+      std::unique_ptr<Row> row = std::move(m_que.front());
+      m_que.pop_front();
+      lk.unlock();
+      m_cv_space.notify_one();
+      std::string error;
       try{
-	m_ttreewriter.reset(m_tfile);
-	m_run_n = run_n;
-      } catch(const Exception &e){
-      EUDAQ_THROW(std::string("Fail to open ROOT file")+e.what());
+	WriteRow(*row);
+      }
+      catch(const std::exception &e){
+	error = e.what();
+      }
+      lk.lock();
+      if(!error.empty() && m_error.empty()){
+	m_error = error;
+	m_cv_space.notify_all();
+      }
+      m_free.push_back(std::move(row));
+    }
+    lk.unlock();
+    try{
+      CloseFile();
     }
+    catch(const std::exception &e){
+      EUDAQ_ERROR(std::string("TTreeFileWriter: ")+e.what());
     }
-    if(!m_ttreewriter)
-      EUDAQ_THROW("TTreeFileWriter: Attempt to write unopened file");
-    uint32_t event_n = ev->GetEventN();
-    TTreeEventConverter::Convert(ev, ttree, GetConfiguration());
   }
 
+  void TTreeFileWriter::WriteRow(Row &row){
+    if(!m_tfile || m_run_n != row.run_n){
+      CloseFile();
+      OpenFile(row.run_n);
+    }
+    m_row.run_n = row.run_n;
+    m_row.event_n = row.event_n;
+    m_row.trigger_n = row.trigger_n;
+    m_row.device_n = row.device_n;
+    m_row.event_flag = row.event_flag;
+    m_row.ts_begin = row.ts_begin;
+    m_row.ts_end = row.ts_end;
+    for(auto &br: m_plane_br){
+      br.second.x->clear();
+      br.second.y->clear();
+      br.second.val->clear();
+      br.second.frame->clear();
+    }
+    for(size_t i = 0; i < row.n_plane; i++){
+      PlaneRow &pr = row.planes[i];
+      PlaneBranches &br = GetPlaneBranches(pr.id);
+      // swap rather than copy, the row gets refilled anyway
+      br.x->swap(pr.x);
+      br.y->swap(pr.y);
+      br.val->swap(pr.val);
+      br.frame->swap(pr.frame);
+    }
+    if(m_ttree->Fill() < 0)
+      EUDAQ_THROW("Fail to fill the tree of run " + std::to_string(m_run_n));
+    m_file_bytes = m_tfile->GetBytesWritten();
+  }
+
+  TTreeFileWriter::PlaneBranches &TTreeFileWriter::GetPlaneBranches(uint32_t id){
+    auto it = m_plane_br.find(id);
+    if(it != m_plane_br.end())
+      return it->second;
+    PlaneRow &buf = m_plane_buf[id];
+    PlaneBranches &br = m_plane_br[id];
+    br.x = &buf.x;
+    br.y = &buf.y;
+    br.val = &buf.val;
+    br.frame = &buf.frame;
+    std::string name = "plane" + std::to_string(id);
+    TBranch *branches[] = {
+      m_ttree->Branch((name+"_x").c_str(), &br.x, m_basket_size),
+      m_ttree->Branch((name+"_y").c_str(), &br.y, m_basket_size),
+      m_ttree->Branch((name+"_val").c_str(), &br.val, m_basket_size),
+      m_ttree->Branch((name+"_frame").c_str(), &br.frame, m_basket_size)};
+    // a plane seen for the first time gets empty entries for the earlier events
+    for(Long64_t i = 0; i < m_ttree->GetEntries(); i++)
+      for(auto b: branches)
+	b->Fill();
+    return br;
+  }
 
+  void TTreeFileWriter::OpenFile(uint32_t run_n){
+    std::time_t time_now = std::time(nullptr);
+    char time_buff[13];
+    time_buff[12] = 0;
+    std::strftime(time_buff, sizeof(time_buff), "%y%m%d%H%M%S", std::localtime(&time_now));
+    std::string time_str(time_buff);
+    std::string foutput(FileNamer(m_filepattern).Set('X', ".root").Set('R', run_n).Set('D', time_str));
+    m_tfile.reset(TFile::Open(foutput.c_str(), "RECREATE", "", m_compression));
+    if(!m_tfile || m_tfile->IsZombie()){
+      m_tfile.reset();
+      EUDAQ_THROW("Fail to open ROOT file " + foutput);
+    }
+    EUDAQ_INFO("Preparing the outputfile: " + foutput);
+    m_run_n = run_n;
+    m_ttree = new TTree("EventTree", "StandardEvents converted from .raw");
+    m_ttree->SetDirectory(m_tfile.get());
+    m_ttree->Branch("run_n", &m_row.run_n, "run_n/i", m_basket_size);
+    m_ttree->Branch("event_n", &m_row.event_n, "event_n/i", m_basket_size);
+    m_ttree->Branch("trigger_n", &m_row.trigger_n, "trigger_n/i", m_basket_size);
+    m_ttree->Branch("device_n", &m_row.device_n, "device_n/i", m_basket_size);
+    m_ttree->Branch("event_flag", &m_row.event_flag, "event_flag/i", m_basket_size);
+    m_ttree->Branch("timestampbegin", &m_row.ts_begin, "timestampbegin/l", m_basket_size);
+    m_ttree->Branch("timestampend", &m_row.ts_end, "timestampend/l", m_basket_size);
+  }
+
+  void TTreeFileWriter::CloseFile(){
+    if(!m_tfile)
+      return;
+    m_tfile->cd();
+    m_ttree->Write("", TObject::kOverwrite);
+    m_file_bytes = m_tfile->GetBytesWritten();
+    m_tfile->Close();
+    m_tfile.reset();
+    m_ttree = nullptr;
+    m_plane_br.clear();
+    m_plane_buf.clear();
+  }
 }
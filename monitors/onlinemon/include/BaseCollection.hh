@@ -72,6 +72,11 @@ class BaseCollection {
   /*!This resets all the histograms ready for a new run*/
   virtual void Reset() = 0;
 
+  //!Update
+  /*!Rebuilds the plots that are computed from buffered event data. It is
+   * called at the update period and before the plots are written*/
+  virtual void Update() {}
+
   //!Set Reduce
   /*!This sets a new value for the parameter _reduce*/
   void setReduce(const unsigned int red);
@@ -20,6 +20,7 @@
 
 #include "CorrelationHistos.hh"
 #include "BaseCollection.hh"
+#include "TrackFinder.hh"
 
 using namespace std;
 class RootMonitor;
@@ -51,7 +52,7 @@ class CorrelationCollection : public BaseCollection {
   bool checkCorrelations(const SimpleStandardCluster &cluster1,
                          const SimpleStandardCluster &cluster2,
                          const bool all_mimosa);
-  void fillHistograms(vector<vector<pair<int, SimpleStandardCluster>>> tracks,
+  void fillHistograms(const vector<TrackFinder::Track> &tracks,
                       const SimpleStandardEvent &simpEv);
   void fillHistograms(const SimpleStandardPlane &p1,
                       const SimpleStandardPlane &p2,
@@ -85,6 +86,12 @@ class CorrelationCollection : public BaseCollection {
     return planesNumberForCorrelation;
   }
   unsigned getWindowWidthForCorrelation() { return windowWidthForCorrelation; }
+  void setMaxMissingPlanesForCorrelation(unsigned param) {
+    maxMissingPlanesForCorrelation = param;
+  }
+  unsigned getMaxMissingPlanesForCorrelation() {
+    return maxMissingPlanesForCorrelation;
+  }
 
 private:
   vector<bool> skip_this_plane; // a array of booleans, initialized with values
@@ -93,6 +100,10 @@ class CorrelationCollection : public BaseCollection {
   vector<int> selected_planes_to_skip;
   unsigned planesNumberForCorrelation;
   unsigned windowWidthForCorrelation;
+  unsigned maxMissingPlanesForCorrelation;
+  TrackFinder _trackFinder;
+  vector<CorrelationHistos *> _trackHistos;
+  vector<bool> _trackHistosFound;
 };
 
 #ifdef __CINT__
@@ -36,6 +36,7 @@ class EUDAQMonitorCollection : public BaseCollection {
   EUDAQMonitorCollection();
   virtual ~EUDAQMonitorCollection();
   void Reset();
+  void Update();
   virtual void Write(TFile *file);
   void Calculate(const unsigned int currentEventNumber);
   void bookHistograms(const SimpleStandardEvent &simpev);
@@ -19,7 +19,9 @@
 #include <sstream>
 #include <iostream>
 #include <mutex>
+#include <chrono>
 #include "SimpleStandardEvent.hh"
+#include "ScalarRing.hh"
 
 using namespace std;
 
@@ -33,6 +35,15 @@ class EUDAQMonitorHistos {
   TH1F *Planes_perEventHisto;
   TProfile *TracksPerEvent;
   TGraph *m_EventN_vs_TimeStamp;
+  TGraph *m_EventRate_vs_Time;
+
+  // per event numbers, the graphs above are made from them in Update()
+  ScalarRing m_ring;
+  size_t m_col_event;
+  size_t m_col_timestamp;
+  size_t m_col_time;
+  std::chrono::steady_clock::time_point m_t0;
+  std::vector<double> m_buf_x, m_buf_y;
 
   std::mutex m_mu;
   
@@ -42,6 +53,7 @@ class EUDAQMonitorHistos {
   void Fill(const SimpleStandardEvent &ev);
   void Fill(const unsigned int evt_nr,
             const unsigned int tracks); // only for tracks per event histogram
+  void Update();
   void Write();
   void Reset();
   TProfile *getHits_vs_Events(unsigned int i) const;
@@ -50,6 +62,7 @@ class EUDAQMonitorHistos {
   TH1F *getPlanes_perEventHisto() const;
   TProfile *getTracksPerEventHisto() const;
   TNamed *getEventN_vs_TimeStamp() const;
+  TNamed *getEventRate_vs_Time() const;
   
   void setPlanes_perEventHisto(TH1F *Planes_perEventHisto);
   unsigned int getNplanes() const;
@@ -60,6 +73,7 @@ class EUDAQMonitorHistos {
   std::mutex* getMutexPlanes_perEvent(){return &m_mu;};
   std::mutex* getMutexTracksPerEvent(){return &m_mu;};
   std::mutex* getMutexEventN_vs_TimeStamp(){return &m_mu;};
+  std::mutex* getMutexEventRate_vs_Time(){return &m_mu;};
 
 private:
   unsigned int nplanes;
@@ -28,6 +28,7 @@ class HitmapCollection : public BaseCollection {
   RQ_OBJECT("HitmapCollection")
 protected:
   bool isOnePlaneRegistered;
+  unsigned int _lastEventNumber;
   std::map<SimpleStandardPlane, HitmapHistos *> _map;
   bool isPlaneRegistered(SimpleStandardPlane p);
   void fillHistograms(const SimpleStandardPlane &simpPlane);
@@ -38,6 +39,7 @@ class HitmapCollection : public BaseCollection {
   void setRootMonitor(RootMonitor *mon) { _mon = mon; }
   HitmapCollection() : BaseCollection() {
     isOnePlaneRegistered = false;
+    _lastEventNumber = 0;
     CollectionType = HITMAP_COLLECTION_TYPE;
   }
   void Fill(const SimpleStandardEvent &simpev);
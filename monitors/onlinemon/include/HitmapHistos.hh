@@ -12,6 +12,7 @@
 #include <TFile.h>
 
 #include <map>
+#include <vector>
 
 #include "SimpleStandardEvent.hh"
 
@@ -100,7 +101,12 @@ class HitmapHistos {
   void setRootMonitor(RootMonitor *mon) { _mon = mon; }
 
 private:
-  int **plane_map_array; // store an array representing the map
+  // hits per pixel (x * _maxY + y), the pixels that have been hit at least
+  // once, and the pixels found to be hot. Calculate only walks _firedPixels,
+  // so its cost follows the number of hit pixels, not the sensor size.
+  std::vector<unsigned int> _pixelCount;
+  std::vector<unsigned int> _firedPixels;
+  std::vector<unsigned char> _hotPixel;
   int zero_plane_array(); // fill array with zeros;
   int SetHistoAxisLabelx(TH1 *histo, string xlabel);
   int SetHistoAxisLabely(TH1 *histo, string ylabel);
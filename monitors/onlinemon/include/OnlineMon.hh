@@ -14,6 +14,7 @@
 #ifndef __CINT__
 #include "eudaq/Monitor.hh"
 #include "eudaq/Event.hh"
+#include "eudaq/StandardEvent.hh"
 #include "eudaq/Logger.hh"
 #include "eudaq/Utils.hh"
 #include "eudaq/OptionParser.hh"
@@ -32,6 +33,12 @@
 // STL includes
 #include <string>
 #include <memory>
+#include <deque>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
 
 using namespace std;
 
@@ -43,7 +50,8 @@ class RootMonitor : public eudaq::Monitor{
 public:
   RootMonitor(const std::string &runcontrol, 
 	      int x, int y, int w, int h,
-              const std::string &conffile = "", const std::string &monname = "");
+              const std::string &conffile = "", const std::string &monname = "",
+              bool headless = false);
   ~RootMonitor() override;
   void DoConfigure() override;
   void DoStartRun() override;
@@ -58,8 +66,12 @@ class RootMonitor : public eudaq::Monitor{
   void setUpdate(const unsigned int up);
   void setCorr_width(const unsigned c_w);
   void setCorr_planes(const unsigned c_p);
+  void setCorr_missing(const unsigned c_m);
   void setUseTrack_corr(const bool t_c);
   void setTracksPerEvent(const unsigned int tracks);
+  void setWorkers(const unsigned int n);
+  void setBlocking(const bool block);
+  void setSnapshotInterval(const unsigned int sec);
   void SetSnapShotDir(string s);
 
   bool getUseTrack_corr() const;
@@ -68,6 +80,26 @@ class RootMonitor : public eudaq::Monitor{
   OnlineMonWindow *getOnlineMon() const;
   OnlineMonConfiguration mon_configdata; // FIXME
 private:
+  // one event going through the pipeline
+  struct MonEvent {
+    uint64_t seq;
+    eudaq::EventSP ev;
+    uint32_t n_plane;
+    std::unique_ptr<SimpleStandardEvent> simpEv;
+    double analysis_time;
+    double clustering_time;
+    bool failed;
+  };
+  void StartPipeline();
+  void StopPipeline();
+  void WaitPipeline();
+  void Converting();
+  void Filling();
+  void BuildSimpleEvent(const eudaq::StandardEvent &stdev, SimpleStandardEvent &simpEv);
+  void FillCollections(SimpleStandardEvent &simpEv);
+  void UpdateCollections();
+  void WriteSnapshot();
+
   std::vector<BaseCollection *> _colls;
   OnlineMonWindow *onlinemon;
   std::string rootfilename;
@@ -89,6 +121,32 @@ class RootMonitor : public eudaq::Monitor{
   unsigned int tracksPerEvent;
   uint32_t m_plane_c;
   uint32_t m_ev_rec_n = 0;
+  unsigned int m_reduce;
+  bool m_auto_reset;
+  unsigned int m_snapshot_interval;
+  unsigned int m_update_period;
+  std::chrono::steady_clock::time_point m_last_update;
+  std::chrono::steady_clock::time_point m_last_snapshot;
+
+  unsigned int m_n_worker;
+  size_t m_max_queue;
+  bool m_blocking;
+  bool m_exit;
+  std::vector<std::thread> m_th_workers;
+  std::thread m_th_fill;
+  std::mutex m_mtx_pipe;
+  // held while histograms are filled or written
+  std::mutex m_mtx_fill;
+  std::condition_variable m_cv_in;
+  std::condition_variable m_cv_space;
+  std::condition_variable m_cv_done;
+  std::deque<MonEvent> m_que_in;
+  std::map<uint64_t, MonEvent> m_que_done;
+  // SimpleStandardEvents handed back by the fill thread, refilled by the workers
+  std::vector<std::unique_ptr<SimpleStandardEvent>> m_simp_pool;
+  uint64_t m_seq_in;
+  uint64_t m_seq_out;
+  uint64_t m_drop_c;
 };
 
 #ifdef __CINT__
@@ -28,6 +28,8 @@
 #include <TGraph.h>
 #include <vector>
 #include <map>
+#include <mutex>
+#include <chrono>
 #include "BaseCollection.hh"
 #include "OnlineMon.hh"
 
@@ -75,6 +77,12 @@ class OnlineMonWindow : public TGMainFrame {
   std::map<std::string, std::string> _hitmapOptions;
   std::map<std::string, unsigned int> _logScaleMap;
   std::map<std::string, std::mutex*> _mutexMap;
+  // copies of the displayed histograms, drawn instead of the live ones
+  std::map<std::string, TNamed *> _snapshotMap;
+  std::vector<std::string> _snapshotList;
+  std::mutex _snapshotMutex;
+  std::chrono::steady_clock::time_point _lastSnapshot;
+  unsigned int _snapshotPeriod;
   TGListTreeItem *Itm_Eudet;
   TGListTreeItem *Itm_DUT;
   TGListTreeItem *Itm_EudetHM;
@@ -98,6 +106,7 @@ class OnlineMonWindow : public TGMainFrame {
   OnlineMonWindow(const TGWindow *p, UInt_t w, UInt_t h);
   #ifndef __CINT__
   void registerMutex(std::string tree, std::mutex *m);
+  void PublishSnapshots(bool force = false);
   #endif
   void registerTreeItem(std::string);
   void makeTreeItemSummary(std::string);
@@ -9,11 +9,13 @@
 #include <vector>
 #include <algorithm>
 #include <map>
+#include <deque>
 #include <iostream>
 
 // project includes
 #include "SimpleStandardEvent.hh"
 #include "BaseCollection.hh"
+#include "ScalarRing.hh"
 
 #include <mutex>
 
@@ -22,20 +24,25 @@ using namespace std;
 class ParaMonitorCollection : public BaseCollection {
 protected:
   void fillHistograms(const SimpleStandardEvent &ev);
-  bool histos_init;
+  void addPlot(const std::string &name);
 
   std::map<std::string, TGraph*> m_graphMap; 
   std::mutex m_mu;
+  // the tags of every event since the last Update(), which parses them
+  std::deque<std::pair<double, std::map<std::string, std::string>>> m_pending;
+  // the parameter values of every tagged event, drawn into m_graphMap by Update()
+  ScalarRing m_ring;
+  size_t m_col_time;
+  std::vector<double> m_buf_x, m_buf_y;
 public:
   ParaMonitorCollection();
   virtual ~ParaMonitorCollection();
   void Reset();
+  void Update();
   virtual void Write(TFile *file);
   void Calculate(const unsigned int currentEventNumber);
-  void bookHistograms(const SimpleStandardEvent &simpev);
   void setRootMonitor(RootMonitor *mon) { _mon = mon; }
   void Fill(const SimpleStandardEvent &simpev);
-  void InitPlots(const SimpleStandardEvent &simpev);
 private:
 
 };
@@ -0,0 +1,49 @@
+/*
+ * ScalarRing.hh
+ *
+ * Column store for per-event numbers, used for the trend plots.
+ */
+
+#ifndef SCALARRING_HH_
+#define SCALARRING_HH_
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <cstdint>
+
+//!Scalar Ring Class
+/*!
+  Keeps the last capacity rows of named double columns. A value that was not
+  set for a row reads as NaN. Nothing is locked internally: the writer and
+  the readers hold getMutex() around their calls.
+ */
+class ScalarRing {
+public:
+  ScalarRing(size_t capacity = 65536);
+  size_t addColumn(const std::string &name);
+  int findColumn(const std::string &name) const;
+  void newRow();
+  void set(size_t col, double value);
+  void clear();
+
+  size_t getCapacity() const { return _capacity; }
+  size_t getNRows() const { return _nRows; }
+  uint64_t getNTotal() const { return _nTotal; }
+  size_t getNColumns() const { return _names.size(); }
+  const std::string &getColumnName(size_t col) const { return _names.at(col); }
+  // oldest row first
+  void getColumn(size_t col, std::vector<double> &out) const;
+  std::mutex *getMutex() { return &_mu; }
+
+private:
+  size_t _capacity;
+  size_t _last; // slot of the current row
+  size_t _nRows;
+  uint64_t _nTotal;
+  std::vector<std::string> _names;
+  std::vector<std::vector<double>> _columns;
+  std::mutex _mu;
+};
+
+#endif /* SCALARRING_HH_ */
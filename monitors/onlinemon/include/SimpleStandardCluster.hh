@@ -17,7 +17,7 @@ class SimpleStandardCluster {
 public:
   SimpleStandardCluster() { _hits.reserve(5); }
 
-  void addPixel(SimpleStandardHit hit) { _hits.push_back(hit); }
+  void addPixel(const SimpleStandardHit &hit) { _hits.push_back(hit); }
   int getNPixel() const { return _hits.size(); }
   int getWidthX() const {
     if (_hits.size() == 1) {
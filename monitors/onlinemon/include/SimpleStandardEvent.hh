@@ -44,14 +44,23 @@ operator<(SimpleStandardPlane const &a,
 class SimpleStandardEvent {
 protected:
   // int _nr;
+  // planes beyond _nPlanes are kept from previous events for reuse
   std::vector<SimpleStandardPlane> _planes;
+  int _nPlanes;
 
 public:
   SimpleStandardEvent();
 
+  void clear();
   void addPlane(SimpleStandardPlane &plane);
-  SimpleStandardPlane getPlane(const int i) const { return _planes.at(i); }
-  int getNPlanes() const { return _planes.size(); }
+  void addPlane(SimpleStandardPlane &&plane);
+  SimpleStandardPlane &addPlane(const std::string &name, const int id,
+                                const int maxX, const int maxY,
+                                OnlineMonConfiguration *mymon);
+  const SimpleStandardPlane &getPlane(const int i) const {
+    return _planes.at(i);
+  }
+  int getNPlanes() const { return _nPlanes; }
   void doClustering();
   double getMonitor_eventanalysistime() const;
   double getMonitor_eventfilltime() const;
@@ -69,6 +78,9 @@ class SimpleStandardEvent {
   void setSlow_para(std::string name, double value);
   bool getSlow_para(std::string name, double &value) const;
   std::vector<std::string> getSlowList() const;
+  // the tags of the event as they came, parsed by the ParaMonitorCollection
+  void setTags(std::map<std::string, std::string> &&tags) { _tags = std::move(tags); }
+  const std::map<std::string, std::string> &getTags() const { return _tags; }
 
 private:
   double monitor_eventfilltime; // stores the time to fill the histogram
@@ -78,6 +90,7 @@ class SimpleStandardEvent {
   unsigned int event_number;
   uint64_t event_timestamp;
   std::map<std::string, double> slowpara;
+  std::map<std::string, std::string> _tags;
 };
 
 #endif
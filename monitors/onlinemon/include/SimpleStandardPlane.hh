@@ -39,35 +39,38 @@ class SimpleStandardPlane {
   std::vector<SimpleStandardHit>
       _rawhits; // stores hits without a threshold in case of analog pixels
   std::vector<SimpleStandardCluster> _clusters;
-  std::vector<SimpleStandardHit> _section_hits[4]; // FIXME hard-coded for
-                                                   // Mimosa
-  std::vector<SimpleStandardCluster>
-      _section_clusters[4]; // FIXME hard-coded for Mimosa
-  
+  int _section_nhits[4];     // FIXME hard-coded for Mimosa
+  int _section_nclusters[4]; // FIXME hard-coded for Mimosa
+
 public:
   SimpleStandardPlane(const std::string &name, const int id, const int maxX,
                       const int maxY, OnlineMonConfiguration *mymon);
   SimpleStandardPlane(const std::string &name, const int id);
-  void addHit(SimpleStandardHit oneHit);
-  void addRawHit(SimpleStandardHit oneHit);
+  void reset(const std::string &name, const int id, const int maxX,
+             const int maxY, OnlineMonConfiguration *mymon);
+  void reserveHits(size_t n) { _hits.reserve(n); }
+  void addHit(const SimpleStandardHit &oneHit);
+  void addRawHit(const SimpleStandardHit &oneHit);
   void doClustering();
-  std::vector<SimpleStandardHit> getHits() const { return _hits; }
-  std::vector<SimpleStandardHit> getRawHits() const { return _rawhits; }
-  std::vector<SimpleStandardCluster> getClusters() const { return _clusters; }
+  const std::vector<SimpleStandardHit> &getHits() const { return _hits; }
+  const std::vector<SimpleStandardHit> &getRawHits() const { return _rawhits; }
+  const std::vector<SimpleStandardCluster> &getClusters() const {
+    return _clusters;
+  }
   int getNHits() const { return _hits.size(); }
   int getNBadHits() const { return _badhits.size(); }
   int getNSectionHits(unsigned int section) const {
-    return _section_hits[section].size();
+    return section < 4 ? _section_nhits[section] : 0;
   }
   int getNClusters() const { return _clusters.size(); }
   int getNSectionClusters(unsigned int section) const {
-    return _section_clusters[section].size();
+    return section < 4 ? _section_nclusters[section] : 0;
   }
-  SimpleStandardCluster getCluster(const int i) const {
+  const SimpleStandardCluster &getCluster(const int i) const {
     return _clusters.at(i);
   }
-  SimpleStandardHit getHit(const int i) const { return _hits.at(i); }
-  SimpleStandardHit getRawHit(const int i) const { return _rawhits.at(i); }
+  const SimpleStandardHit &getHit(const int i) const { return _hits.at(i); }
+  const SimpleStandardHit &getRawHit(const int i) const { return _rawhits.at(i); }
   std::string getName() const { return _name; }
   int getID() const { return _id; }
   int getMaxX() { return _maxX; }
@@ -0,0 +1,64 @@
+/*
+ * TrackFinder.hh
+ *
+ * Road search used for the track based correlation plots.
+ */
+
+#ifndef TRACKFINDER_HH_
+#define TRACKFINDER_HH_
+
+#include <vector>
+
+#include "include/SimpleStandardCluster.hh"
+
+//!Track Finder Class
+/*!
+  The clusters of every plane are kept sorted by x, so the candidates inside
+  the search window around the last point of a track are found by binary
+  search. A track may skip up to maxMissingPlanes planes. The buffers are
+  reused from one event to the next.
+ */
+class TrackFinder {
+public:
+  struct TrackPoint {
+    int plane; // index of the plane in the SimpleStandardEvent
+    const SimpleStandardCluster *cluster;
+  };
+  typedef std::vector<TrackPoint> Track;
+
+  TrackFinder();
+  void setWindow(int window) { _window = window; }
+  void setMinPlanes(unsigned int n) { _minPlanes = n; }
+  void setMaxMissingPlanes(unsigned int n) { _maxMissingPlanes = n; }
+  void clear();
+  void addPlane(int plane, bool correlate,
+                const std::vector<SimpleStandardCluster> &clusters,
+                int minSeedSize);
+  const std::vector<Track> &findTracks();
+
+private:
+  struct Candidate {
+    int x;
+    int y;
+    const SimpleStandardCluster *cluster;
+    bool seed;
+    bool used;
+  };
+  struct Plane {
+    int index;
+    bool correlate;
+    std::vector<Candidate> candidates;
+  };
+  Candidate *findClosest(Plane &plane, const Candidate &last);
+
+  std::vector<Plane> _planes;
+  unsigned int _nPlanes;
+  std::vector<Track> _tracks;
+  Track _track;
+  std::vector<Candidate *> _trackCandidates;
+  int _window;
+  unsigned int _minPlanes;
+  unsigned int _maxMissingPlanes;
+};
+
+#endif /* TRACKFINDER_HH_ */
@@ -11,7 +11,8 @@
 CorrelationCollection::CorrelationCollection()
     : BaseCollection(), _map(), _planes(), skip_this_plane(),
       correlateAllPlanes(false), selected_planes_to_skip(),
-      planesNumberForCorrelation(0), windowWidthForCorrelation(0) {
+      planesNumberForCorrelation(0), windowWidthForCorrelation(0),
+      maxMissingPlanesForCorrelation(0) {
   CollectionType = CORRELATION_COLLECTION_TYPE;
 }
 
@@ -165,14 +166,6 @@ unsigned int
 CorrelationCollection::FillWithTracks(const SimpleStandardEvent &simpev) {
   int nPlanes = simpev.getNPlanes();
   int nPlanes_disabled = 0;
-  std::vector<vector<SimpleStandardCluster>> clustersInPlanes;
-  std::vector<vector<pair<int, SimpleStandardCluster>>> reconstructedTracks;
-  std::vector<pair<int, SimpleStandardCluster>> singleTrack;
-  singleTrack.reserve(nPlanes);
-  bool noClusterFound;
-  const int lastPlane = nPlanes - 1;
-  SimpleStandardCluster tempCluster;
-  bool correlationDecission;
 
   unsigned int plane_vector_size = 0;
   if (skip_this_plane.size() == 0) // do this only at the very first event
@@ -199,28 +192,25 @@ CorrelationCollection::FillWithTracks(const SimpleStandardEvent &simpev) {
       std::cout << "CorrelationCollection : Disabling " << nPlanes_disabled
                 << " Planes" << endl;
   }
+
+  _trackFinder.clear();
+  _trackFinder.setWindow(getWindowWidthForCorrelation());
+  _trackFinder.setMinPlanes(getPlanesNumberForCorrelation());
+  _trackFinder.setMaxMissingPlanes(getMaxMissingPlanesForCorrelation());
   if (nPlanes - nPlanes_disabled < 2) {
     if (nPlanes > 2)
       std::cout << "CorrelationCollection : Too Many Planes Disabled ..."
                 << endl;
   } else {
-    clustersInPlanes.reserve(nPlanes);
-
     for (int planeA = 0; planeA < nPlanes; planeA++) {
       const SimpleStandardPlane &simpPlane = simpev.getPlane(planeA);
       if (skip_this_plane[planeA] ==
           false) // adding plane for analysis if selected
       {
-        vector<SimpleStandardCluster> clustersBeforeDeletion =
-            simpPlane.getClusters();
-        vector<SimpleStandardCluster> clustersAfterDeletion;
-        clustersAfterDeletion.reserve(20);
-        remove_copy_if(
-            clustersBeforeDeletion.begin(), clustersBeforeDeletion.end(),
-            back_inserter(clustersAfterDeletion), checkIfClusterIsBigEnough);
-        //                cout<< "Clusters: " << clustersAfterDeletion.size() <<
-        //                endl;
-        clustersInPlanes.push_back(clustersAfterDeletion);
+        // only pairs of Mimosa planes are correlated
+        _trackFinder.addPlane(planeA, simpPlane.is_MIMOSA26,
+                              simpPlane.getClusters(),
+                              _mon->mon_configdata.getCorrel_minclustersize());
 
         if (!isPlaneRegistered(simpPlane)) {
           plane_vector_size =
@@ -246,103 +236,42 @@ CorrelationCollection::FillWithTracks(const SimpleStandardEvent &simpev) {
       }
     }
   }
-  for (unsigned int plane = 0; plane < clustersInPlanes.size(); ++plane)
-    std::sort(clustersInPlanes.at(plane).begin(),
-              clustersInPlanes.at(plane).end(), SortClustersByXY());
-
-  for (unsigned int currPlaneIndex = 0;
-       currPlaneIndex < clustersInPlanes.size() - 2; ++currPlaneIndex) {
-    std::vector<SimpleStandardCluster> &currentPlane =
-        clustersInPlanes.at(currPlaneIndex);
-
-    singleTrack.clear();
-    while (currentPlane.size() > 0) {
-      if (singleTrack.size() > 0)
-        singleTrack.clear();
-
-      while (singleTrack.size() == 0 && currentPlane.size() > 0) {
-        tempCluster = currentPlane.back();
-        if (tempCluster.getNPixel() >=
-            _mon->mon_configdata.getCorrel_minclustersize()) {
-          std::pair<int, SimpleStandardCluster> trackPair(currPlaneIndex,
-                                                          tempCluster);
-          singleTrack.push_back(trackPair);
-        }
-        currentPlane.pop_back();
-      }
-
-      if (singleTrack.size() > 0) {
-        for (int nextPlaneIndex = ++currPlaneIndex; nextPlaneIndex < nPlanes;
-             ++nextPlaneIndex) {
-          std::vector<SimpleStandardCluster> &clustersInNextPlane =
-              clustersInPlanes.at(nextPlaneIndex);
-          noClusterFound = false;
-
-          //                    for(std::vector<SimpleStandardCluster>::iterator
-          //                    it = --nextPlane.end(); it >= nextPlane.begin();
-          //                    --it)
-          //                    int currentSize = clustersInNextPlane.size();
-          for (int currentclusterIndex = clustersInNextPlane.size() - 1;
-               currentclusterIndex >= 0; --currentclusterIndex) {
-            SimpleStandardCluster &currentCluster =
-                clustersInNextPlane.at(currentclusterIndex);
-            //                        if( currentCluster.getNPixel() >=
-            //                        _mon->mon_configdata.getCorrel_minclustersize()
-            //                                &&
-            //                                checkCorrelations(singleTrack.back().second,
-            //                                currentCluster) )
-
-            if (simpev.getPlane(currPlaneIndex).is_MIMOSA26 &&
-                simpev.getPlane(nextPlaneIndex).is_MIMOSA26)
-              correlationDecission =
-                  checkCorrelations(singleTrack.back().second, currentCluster);
-            else
-              correlationDecission = checkCorrelations(
-                  singleTrack.back().second, currentCluster, false);
-            if (correlationDecission) {
-              std::pair<int, SimpleStandardCluster> trackPair(nextPlaneIndex,
-                                                              currentCluster);
-              singleTrack.push_back(trackPair);
-              clustersInNextPlane.erase(clustersInNextPlane.begin() +
-                                        currentclusterIndex);
-              break;
-            } else if (currentclusterIndex == 0)
-              noClusterFound = true;
-          }
 
-          if (nextPlaneIndex == lastPlane || noClusterFound) {
-            if (singleTrack.size() >= getPlanesNumberForCorrelation())
-              reconstructedTracks.push_back(singleTrack);
-          }
-        }
-      }
-    }
-  }
-  fillHistograms(reconstructedTracks, simpev);
-  return reconstructedTracks.size();
+  const std::vector<TrackFinder::Track> &tracks = _trackFinder.findTracks();
+  fillHistograms(tracks, simpev);
+  return tracks.size();
 }
 
 void CorrelationCollection::fillHistograms(
-    std::vector<vector<pair<int, SimpleStandardCluster>>> tracks,
+    const std::vector<TrackFinder::Track> &tracks,
     const SimpleStandardEvent &simpEv) {
+  // histograms of each pair of planes, looked up once per event
+  const unsigned int nPlanes = simpEv.getNPlanes();
+  _trackHistos.assign(nPlanes * nPlanes, NULL);
+  _trackHistosFound.assign(nPlanes * nPlanes, false);
 
   for (unsigned int trackNr = 0; trackNr < tracks.size(); ++trackNr) {
-    vector<pair<int, SimpleStandardCluster>> &currentTrack = tracks.at(trackNr);
+    const TrackFinder::Track &currentTrack = tracks.at(trackNr);
     for (unsigned int clusterPair1 = 0; clusterPair1 < currentTrack.size() - 1;
          ++clusterPair1) {
       for (unsigned int clusterPair2 = clusterPair1 + 1;
            clusterPair2 < currentTrack.size(); ++clusterPair2) {
-        const SimpleStandardPlane &firstPlane =
-            simpEv.getPlane(currentTrack.at(clusterPair1).first);
+        const int plane1 = currentTrack.at(clusterPair1).plane;
+        const int plane2 = currentTrack.at(clusterPair2).plane;
+        const unsigned int pairIndex = plane1 * nPlanes + plane2;
+        if (!_trackHistosFound[pairIndex]) {
+          pair<SimpleStandardPlane, SimpleStandardPlane> planePair(
+              simpEv.getPlane(plane1), simpEv.getPlane(plane2));
+          _trackHistos[pairIndex] = _map[planePair];
+          _trackHistosFound[pairIndex] = true;
+        }
+        CorrelationHistos *corrmap = _trackHistos[pairIndex];
+        if (!corrmap)
+          continue;
         const SimpleStandardCluster &firstCluster =
-            currentTrack.at(clusterPair1).second;
-        const SimpleStandardPlane &secondPlane =
-            simpEv.getPlane(currentTrack.at(clusterPair2).first);
+            *currentTrack.at(clusterPair1).cluster;
         const SimpleStandardCluster &secondCluster =
-            currentTrack.at(clusterPair2).second;
-        pair<SimpleStandardPlane, SimpleStandardPlane> planePair(firstPlane,
-                                                                 secondPlane);
-        CorrelationHistos *corrmap = _map[planePair];
+            *currentTrack.at(clusterPair2).cluster;
 
         corrmap->Fill(firstCluster, secondCluster);
 	corrmap->FillCorrVsTime(firstCluster, secondCluster, simpEv);
@@ -358,8 +287,8 @@ void CorrelationCollection::fillHistograms(const SimpleStandardPlane &p1,
   std::pair<SimpleStandardPlane, SimpleStandardPlane> plane(p1, p2);
   CorrelationHistos *corrmap = _map[plane];
   if (corrmap) {
-    const std::vector<SimpleStandardCluster> aClusters = p1.getClusters();
-    const std::vector<SimpleStandardCluster> bClusters = p2.getClusters();
+    const std::vector<SimpleStandardCluster> &aClusters = p1.getClusters();
+    const std::vector<SimpleStandardCluster> &bClusters = p2.getClusters();
 
     for (unsigned int acluster = 0; acluster < aClusters.size(); acluster++) {
       const SimpleStandardCluster &oneAcluster = aClusters.at(acluster);
@@ -395,7 +324,7 @@ void CorrelationCollection::registerPlaneCorrelations(
   pair<SimpleStandardPlane, SimpleStandardPlane> pdouble(p1, p2);
   _map[pdouble] = tmphisto;
 
-  if (_mon != NULL) {
+  if (_mon != NULL && _mon->getOnlineMon() != NULL) {
     std::string dirName;
 
     if (_mon->getUseTrack_corr() == true)
@@ -427,7 +356,7 @@ void CorrelationCollection::registerPlaneCorrelations(
   }
 
 
-  if (_mon != NULL) {
+  if (_mon != NULL && _mon->getOnlineMon() != NULL) {
     std::string dirName;
 
     if (_mon->getUseTrack_corr() == true)
@@ -27,6 +27,11 @@ void EUDAQMonitorCollection::Reset() {
     mymonhistos->Reset();
 }
 
+void EUDAQMonitorCollection::Update() {
+  if (mymonhistos != NULL)
+    mymonhistos->Update();
+}
+
 void EUDAQMonitorCollection::Write(TFile *file) {
   if (file == NULL) {
     std::cerr << "EUDAQMonitorCollection::Write File pointer is NULL" << endl;
@@ -43,7 +48,7 @@ void EUDAQMonitorCollection::Write(TFile *file) {
 
 void EUDAQMonitorCollection::bookHistograms(
     const SimpleStandardEvent & /*simpev*/) {
-  if (_mon != NULL) {
+  if (_mon != NULL && _mon->getOnlineMon() != NULL) {
     string performance_folder_name = "EUDAQ Monitor";
     _mon->getOnlineMon()->registerTreeItem(
         (performance_folder_name + "/Number of Planes"));
@@ -81,6 +86,15 @@ void EUDAQMonitorCollection::bookHistograms(
     _mon->getOnlineMon()->registerMutex(
         (performance_folder_name + "/EventN vs TimeStamp"),
         mymonhistos->getMutexEventN_vs_TimeStamp());
+
+    _mon->getOnlineMon()->registerTreeItem(
+        (performance_folder_name + "/Event Rate vs Time"));
+    _mon->getOnlineMon()->registerHisto(
+        (performance_folder_name + "/Event Rate vs Time"),
+        mymonhistos->getEventRate_vs_Time(), "AL");
+    _mon->getOnlineMon()->registerMutex(
+        (performance_folder_name + "/Event Rate vs Time"),
+        mymonhistos->getMutexEventRate_vs_Time());
     
     
     if (_mon->getUseTrack_corr()) {
@@ -6,6 +6,8 @@
  */
 
 #include "../include/EUDAQMonitorHistos.hh"
+#include <cmath>
+#include <algorithm>
 
 EUDAQMonitorHistos::EUDAQMonitorHistos(const SimpleStandardEvent &ev) {
   nplanes = ev.getNPlanes();
@@ -27,6 +29,15 @@ EUDAQMonitorHistos::EUDAQMonitorHistos(const SimpleStandardEvent &ev) {
   m_EventN_vs_TimeStamp->GetXaxis()->SetTitle("timestamp");
   m_EventN_vs_TimeStamp->GetYaxis()->SetTitle("event number");
 
+  m_EventRate_vs_Time = new TGraph();
+  m_EventRate_vs_Time->SetTitle("analysed events per second");
+  m_EventRate_vs_Time->GetXaxis()->SetTitle("time [s]");
+  m_EventRate_vs_Time->GetYaxis()->SetTitle("rate [Hz]");
+
+  m_col_event = m_ring.addColumn("event");
+  m_col_timestamp = m_ring.addColumn("timestamp");
+  m_col_time = m_ring.addColumn("time");
+
   
 #ifdef EUDAQ_LIB_ROOT6
   Hits_vs_EventsTotal->SetCanExtend(TH1::kAllAxes);
@@ -83,7 +94,54 @@ void EUDAQMonitorHistos::Fill(const SimpleStandardEvent &ev) {
   }
   Hits_vs_EventsTotal->Fill(event_nr, nhits_total);
 
-  m_EventN_vs_TimeStamp->SetPoint(m_EventN_vs_TimeStamp->GetN(),ev.getEvent_timestamp(), ev.getEvent_number());
+  auto now = std::chrono::steady_clock::now();
+  std::lock_guard<std::mutex> lck_ring(*m_ring.getMutex());
+  if (m_ring.getNTotal() == 0)
+    m_t0 = now;
+  m_ring.newRow();
+  m_ring.set(m_col_event, event_nr);
+  m_ring.set(m_col_timestamp, ev.getEvent_timestamp());
+  m_ring.set(m_col_time, std::chrono::duration<double>(now - m_t0).count());
+}
+
+// Rebuilds the trend graphs from the ring, only when they are going to be
+// looked at instead of for every event.
+void EUDAQMonitorHistos::Update() {
+  std::vector<double> event, timestamp, time;
+  {
+    std::lock_guard<std::mutex> lck_ring(*m_ring.getMutex());
+    m_ring.getColumn(m_col_event, event);
+    m_ring.getColumn(m_col_timestamp, timestamp);
+    m_ring.getColumn(m_col_time, time);
+  }
+
+  // events per one second bin
+  m_buf_x.clear();
+  m_buf_y.clear();
+  if (!time.empty()) {
+    double bin = std::floor(time.front());
+    double count = 0;
+    for (double t : time) {
+      if (t >= bin + 1) {
+        m_buf_x.push_back(bin + 0.5);
+        m_buf_y.push_back(count);
+        bin = std::floor(t);
+        count = 0;
+      }
+      count++;
+    }
+    // the last second, which may not be complete yet
+    m_buf_x.push_back(bin + 0.5);
+    m_buf_y.push_back(count);
+  }
+
+  std::lock_guard<std::mutex> lck(m_mu);
+  m_EventN_vs_TimeStamp->Set(event.size());
+  for (size_t i = 0; i < event.size(); i++)
+    m_EventN_vs_TimeStamp->SetPoint(i, timestamp[i], event[i]);
+  m_EventRate_vs_Time->Set(m_buf_x.size());
+  for (size_t i = 0; i < m_buf_x.size(); i++)
+    m_EventRate_vs_Time->SetPoint(i, m_buf_x[i], m_buf_y[i]);
 }
 
 void EUDAQMonitorHistos::Fill(const unsigned int evt_number,
@@ -99,12 +157,18 @@ void EUDAQMonitorHistos::Write() {
   }
   Hits_vs_EventsTotal->Write();
   TracksPerEvent->Write();
+  m_EventN_vs_TimeStamp->Write("EventN_vs_TimeStamp");
+  m_EventRate_vs_Time->Write("EventRate_vs_Time");
 }
 
 TNamed *EUDAQMonitorHistos::getEventN_vs_TimeStamp() const{
   return m_EventN_vs_TimeStamp;
 }
 
+TNamed *EUDAQMonitorHistos::getEventRate_vs_Time() const{
+  return m_EventRate_vs_Time;
+}
+
 TProfile *EUDAQMonitorHistos::getHits_vs_Events(unsigned int i) const {
   return Hits_vs_Events[i];
 }
@@ -139,4 +203,8 @@ void EUDAQMonitorHistos::Reset() {
   }
   Hits_vs_EventsTotal->Reset();
   TracksPerEvent->Reset();
+  m_EventN_vs_TimeStamp->Set(0);
+  m_EventRate_vs_Time->Set(0);
+  std::lock_guard<std::mutex> lck_ring(*m_ring.getMutex());
+  m_ring.clear();
 }
@@ -81,7 +81,7 @@ void HitmapCollection::Write(TFile *file) {
 }
 
 void HitmapCollection::Calculate(const unsigned int currentEventNumber) {
-  if ((currentEventNumber > 10 && currentEventNumber % 1000 * _reduce == 0)) {
+  if (currentEventNumber > 10) {
     std::map<SimpleStandardPlane, HitmapHistos *>::iterator it;
     for (it = _map.begin(); it != _map.end(); ++it) {
       it->second->Calculate(currentEventNumber / _reduce);
@@ -90,6 +90,7 @@ void HitmapCollection::Calculate(const unsigned int currentEventNumber) {
 }
 
 void HitmapCollection::Reset() {
+  _lastEventNumber = 0;
   std::map<SimpleStandardPlane, HitmapHistos *>::iterator it;
   for (it = _map.begin(); it != _map.end(); ++it) {
     (*it).second->Reset();
@@ -97,11 +98,18 @@ void HitmapCollection::Reset() {
 }
 
 void HitmapCollection::Fill(const SimpleStandardEvent &simpev) {
+  // the occupancy and hot pixel plots walk all fired pixels; they are rebuilt
+  // every 1000 events, also when the event on the boundary was not sampled
+  unsigned int eventNumber = simpev.getEvent_number();
+  bool calculate = eventNumber / 1000 != _lastEventNumber / 1000;
+  _lastEventNumber = eventNumber;
 
   for (int plane = 0; plane < simpev.getNPlanes(); plane++) {
     const SimpleStandardPlane &simpPlane = simpev.getPlane(plane);
     fillHistograms(simpPlane);
   }
+  if (calculate)
+    Calculate(eventNumber);
 }
 HitmapHistos *HitmapCollection::getHitmapHistos(std::string sensor, int id) {
   SimpleStandardPlane sp(sensor, id);
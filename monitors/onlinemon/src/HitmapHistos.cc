@@ -200,17 +200,8 @@ HitmapHistos::HitmapHistos(SimpleStandardPlane p, RootMonitor *mon)
     }
     // make a plane array for calculating e..g hotpixels and occupancy
 
-    plane_map_array = new int *[_maxX];
-    if (plane_map_array != NULL) {
-      for (int j = 0; j < _maxX; j++) {
-        plane_map_array[j] = new int[_maxY];
-        if (plane_map_array[j] == NULL) {
-	  std::cerr << "HitmapHistos :Error in memory allocation" << endl;
-          exit(-1);
-        }
-      }
-      zero_plane_array();
-    }
+    _pixelCount.assign(_maxX * _maxY, 0);
+    _hotPixel.assign(_maxX * _maxY, 0);
 
   } else {
     std::cerr << "No max sensorsize known!" << std::endl;
@@ -218,11 +209,11 @@ HitmapHistos::HitmapHistos(SimpleStandardPlane p, RootMonitor *mon)
 }
 
 int HitmapHistos::zero_plane_array() {
-  for (int i = 0; i < _maxX; i++) {
-    for (int j = 0; j < _maxY; j++) {
-      plane_map_array[i][j] = 0;
-    }
+  for (unsigned int i : _firedPixels) {
+    _pixelCount[i] = 0;
+    _hotPixel[i] = 0;
   }
+  _firedPixels.clear();
   return 0;
 }
 
@@ -230,10 +221,9 @@ void HitmapHistos::Fill(const SimpleStandardHit &hit) {
   int pixel_x = hit.getX();
   int pixel_y = hit.getY();
 
-  bool pixelIsHot = false;
-  if (_HotPixelMap->GetBinContent(pixel_x + 1, pixel_y + 1) >
-      _mon->mon_configdata.getHotpixelcut())
-    pixelIsHot = true;
+  bool inside = pixel_x >= 0 && pixel_x < _maxX && pixel_y >= 0 && pixel_y < _maxY;
+  unsigned int index = inside ? pixel_x * _maxY + pixel_y : 0;
+  bool pixelIsHot = inside && _hotPixel[index];
 
   if (_hitmap != NULL && !pixelIsHot){
     _hitmap->Fill(pixel_x, pixel_y);
@@ -254,8 +244,8 @@ void HitmapHistos::Fill(const SimpleStandardHit &hit) {
                           1); // add one hit to the corresponding section bin
   }
 
-  if ((pixel_x < _maxX) && (pixel_y < _maxY)) {
-    plane_map_array[pixel_x][pixel_y] = plane_map_array[pixel_x][pixel_y] + 1;
+  if (inside && _pixelCount[index]++ == 0) {
+    _firedPixels.push_back(index);
   }
   if ((is_APIX) || (is_USBPIX) || (is_USBPIXI4) || (is_DEPFET)) {
     if (_totSingle != NULL)
@@ -358,6 +348,8 @@ void HitmapHistos::Reset() {
 }
 
 void HitmapHistos::Calculate(const int currentEventNum) {
+  if (currentEventNum <= 0)
+    return;
   _wait = true;
   _hitOcc->SetBins(currentEventNum / 10, 0, 1);
   _hitOcc->Reset();
@@ -365,42 +357,34 @@ void HitmapHistos::Calculate(const int currentEventNum) {
   int nHotpixels = 0;
   std::vector<unsigned int> nHotpixels_section;
   double Hotpixelcut = _mon->mon_configdata.getHotpixelcut();
-  double bin = 0;
-  double occupancy = 0;
-  if (is_MIMOSA26) // probalbly initialize vector
-  {
-    nHotpixels_section.reserve(_mon->mon_configdata.getMimosa26_max_sections());
-    for (unsigned int i = 0; i < _mon->mon_configdata.getMimosa26_max_sections(); i++) {
-      nHotpixels_section[i] = 0;
-    }
-  }
-
-  for (int x = 0; x < _maxX; ++x) {
-    for (int y = 0; y < _maxY; ++y) {
-
-      bin = plane_map_array[x][y];
-
-      if (bin != 0) {
-        occupancy = bin / (double)currentEventNum; // FIXME it's not occupancy, it's frequency
-        _hitOcc->Fill(occupancy);
-        // only count as hotpixel if occupancy larger than minimal occupancy for
-        // a single hit
-        if (occupancy > Hotpixelcut && ((1. / (double)(currentEventNum)) <
-                                        _mon->mon_configdata.getHotpixelcut())){
-          nHotpixels++;
-          _HotPixelMap->SetBinContent(x + 1, y + 1, occupancy); // ROOT start from 1
-          if (is_MIMOSA26) {
-            nHotpixels_section[x / _mon->mon_configdata.getMimosa26_section_boundary()]++;
-          }
-        }
+  // only count as hotpixel if occupancy larger than minimal occupancy for a
+  // single hit
+  bool findHot = (1. / (double)currentEventNum) < Hotpixelcut;
+  // occupancy > Hotpixelcut  <=>  count > hotCount
+  double hotCount = Hotpixelcut * currentEventNum;
+  unsigned int sectionBoundary = _mon->mon_configdata.getMimosa26_section_boundary();
+  if (is_MIMOSA26)
+    nHotpixels_section.assign(mimosa26_max_section, 0);
+
+  for (unsigned int index : _firedPixels) {
+    unsigned int bin = _pixelCount[index];
+    double occupancy = bin / (double)currentEventNum; // FIXME it's not occupancy, it's frequency
+    _hitOcc->Fill(occupancy);
+    if (findHot && bin > hotCount) {
+      int x = index / _maxY;
+      int y = index % _maxY;
+      nHotpixels++;
+      _hotPixel[index] = 1;
+      _HotPixelMap->SetBinContent(x + 1, y + 1, occupancy); // ROOT start from 1
+      if (is_MIMOSA26 && x / sectionBoundary < mimosa26_max_section) {
+        nHotpixels_section[x / sectionBoundary]++;
       }
     }
   }
   if (nHotpixels > 0) {
     _nHotPixels->Fill(nHotpixels);
     if (is_MIMOSA26) {
-      for (unsigned int section = 0;
-           section < _mon->mon_configdata.getMimosa26_max_sections();
+      for (unsigned int section = 0; section < mimosa26_max_section;
            section++) {
         if ((nHotpixels_section[section] > 0)) {
           _nHotPixels_section[section]->Fill(nHotpixels_section[section]);
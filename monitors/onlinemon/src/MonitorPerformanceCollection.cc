@@ -49,7 +49,7 @@ void MonitorPerformanceCollection::Fill(const SimpleStandardEvent &simpev) {
 
 void MonitorPerformanceCollection::bookHistograms(
     const SimpleStandardEvent & /*simpev*/) {
-  if (_mon != NULL) {
+  if (_mon != NULL && _mon->getOnlineMon() != NULL) {
     string performance_folder_name = "Monitor Performance";
     _mon->getOnlineMon()->registerTreeItem(
         (performance_folder_name + "/Data Analysis Time"));
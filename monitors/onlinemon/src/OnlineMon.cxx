@@ -35,11 +35,13 @@
 #include <string>
 #include <map>
 #include <cstring>
+#include <cstdio>
 #include <stdio.h>
 #include <string.h>
 #include <chrono>
 #include <thread>
 #include <memory>
+#include <algorithm>
 
 //ONLINE MONITOR Includes
 #include "OnlineMon.hh"
@@ -50,13 +52,21 @@ using namespace std;
 
 RootMonitor::RootMonitor(const std::string & runcontrol,
 			 int /*x*/, int /*y*/, int /*w*/, int /*h*/,
-			 const std::string & conffile, const std::string & monname)
-  :eudaq::Monitor(monname, runcontrol), _planesInitialized(false), onlinemon(NULL){
-  onlinemon = new OnlineMonWindow(gClient->GetRoot(),800,600);
-
-  if (onlinemon==NULL){
-    std::cerr<< "Error Allocationg OnlineMonWindow"<<endl;
-    exit(-1);
+			 const std::string & conffile, const std::string & monname,
+			 bool headless)
+  :eudaq::Monitor(monname, runcontrol), _planesInitialized(false), onlinemon(NULL),
+   m_reduce(1), m_auto_reset(false), m_snapshot_interval(0), m_update_period(1000),
+   m_n_worker(1), m_max_queue(1024), m_blocking(false), m_exit(false),
+   m_seq_in(0), m_seq_out(0), m_drop_c(0){
+  // in headless mode there is no window, the histograms are only written to
+  // the snapshot files
+  if (!headless){
+    onlinemon = new OnlineMonWindow(gClient->GetRoot(),800,600);
+
+    if (onlinemon==NULL){
+      std::cerr<< "Error Allocationg OnlineMonWindow"<<endl;
+      exit(-1);
+    }
   }
 
   m_plane_c = 0;
@@ -82,7 +92,8 @@ RootMonitor::RootMonitor(const std::string & runcontrol,
   eudaqCollection->setRootMonitor(this);
   paraCollection->setRootMonitor(this);
 
-  onlinemon->setCollections(_colls);
+  if (onlinemon)
+    onlinemon->setCollections(_colls);
 
   //initialize with default configuration
   mon_configdata.SetDefaults();
@@ -106,12 +117,15 @@ RootMonitor::RootMonitor(const std::string & runcontrol,
   previous_event_clustering_time=0;
   previous_event_correlation_time=0;
 
-  onlinemon->SetOnlineMon(this);    
+  if (onlinemon)
+    onlinemon->SetOnlineMon(this);
 
 }
 
 RootMonitor::~RootMonitor(){
-  gApplication->Terminate();
+  StopPipeline();
+  if (gApplication)
+    gApplication->Terminate();
 }
 
 OnlineMonWindow* RootMonitor::getOnlineMon() const {
@@ -129,8 +143,14 @@ void RootMonitor::setCorr_planes(const unsigned c_p) {
   corrCollection->setPlanesNumberForCorrelation(c_p);
 }
 
+void RootMonitor::setCorr_missing(const unsigned c_m) {
+  corrCollection->setMaxMissingPlanesForCorrelation(c_m);
+}
+
 void RootMonitor::setReduce(const unsigned int red) {
-  onlinemon->setReduce(red);
+  m_reduce = red ? red : 1;
+  if (onlinemon)
+    onlinemon->setReduce(red);
   for (unsigned int i = 0 ; i < _colls.size(); ++i)
   {
     _colls.at(i)->setReduce(red);
@@ -153,56 +173,207 @@ unsigned int RootMonitor::getTracksPerEvent() const {
   return tracksPerEvent;
 }
 
+void RootMonitor::setWorkers(const unsigned int n) {
+  m_n_worker = n ? n : 1;
+}
+
+// wait for free space in the pipeline instead of dropping events (offline mode)
+void RootMonitor::setBlocking(const bool block) {
+  m_blocking = block;
+}
+
 void RootMonitor::DoConfigure(){
   auto &param = *GetConfiguration();
   std::cout << "Configure: " << param.Name() << std::endl;
 }
 
 void RootMonitor::DoTerminate(){
-  gApplication->Terminate();
+  if (gApplication)
+    gApplication->Terminate();
 }  
 
+void RootMonitor::StartPipeline() {
+  std::unique_lock<std::mutex> lk(m_mtx_pipe);
+  if(m_th_fill.joinable())
+    return;
+  m_exit = false;
+  for(unsigned int i = 0; i < m_n_worker; i++)
+    m_th_workers.emplace_back(&RootMonitor::Converting, this);
+  m_th_fill = std::thread(&RootMonitor::Filling, this);
+}
+
+void RootMonitor::StopPipeline() {
+  std::unique_lock<std::mutex> lk(m_mtx_pipe);
+  m_exit = true;
+  lk.unlock();
+  m_cv_in.notify_all();
+  m_cv_done.notify_all();
+  for(auto &th: m_th_workers)
+    if(th.joinable())
+      th.join();
+  m_th_workers.clear();
+  if(m_th_fill.joinable())
+    m_th_fill.join();
+}
+
+// blocks until every event handed to DoReceive has been filled
+void RootMonitor::WaitPipeline() {
+  std::unique_lock<std::mutex> lk(m_mtx_pipe);
+  m_cv_done.wait(lk, [this](){return m_seq_out == m_seq_in;});
+}
+
 void RootMonitor::DoReceive(eudaq::EventSP evsp) {
-  if(evsp->GetEventN() > 10 && evsp->GetEventN() % onlinemon->getReduce() != 0){
+  if(evsp->GetEventN() > 10 && evsp->GetEventN() % m_reduce != 0){
     return;
   }
-  
-  auto stdev = std::dynamic_pointer_cast<eudaq::StandardEvent>(evsp);
-  if(!stdev){
-    stdev = eudaq::StandardEvent::MakeShared();
-    eudaq::StdEventConverter::Convert(evsp, stdev, nullptr); //no conf
+  std::unique_lock<std::mutex> lk(m_mtx_pipe);
+  if(!m_th_fill.joinable()){
+    lk.unlock();
+    StartPipeline();
+    lk.lock();
   }
-  
-  uint32_t ev_plane_c = stdev->NumPlanes();
-  if(m_ev_rec_n < 10){
-    m_ev_rec_n ++;
-    if(ev_plane_c > m_plane_c){
-      m_plane_c = ev_plane_c;
+  // the limit counts every event in the pipeline, queued, converted or
+  // waiting for its turn to be filled
+  if(m_seq_in - m_seq_out >= m_max_queue){
+    if(!m_blocking){
+      m_drop_c++;
+      CountDropped();
+      return;
     }
-    return;
+    m_cv_space.wait(lk, [this](){return m_seq_in - m_seq_out < m_max_queue;});
   }
+  m_que_in.push_back(MonEvent{m_seq_in++, evsp, 0, nullptr, 0, 0, false});
+  lk.unlock();
+  m_cv_in.notify_one();
+}
 
-  if(ev_plane_c != m_plane_c){
-    std::cout<< "Event #"<< evsp->GetEventN()<< " has "<<ev_plane_c<<" plane(s), while we expect "<< m_plane_c <<" plane(s).  (Event is skipped)" <<std::endl;
-    return;
+// conversion and clustering, on several threads
+void RootMonitor::Converting() {
+  eudaq::StdEventSP stdev_buf;
+  std::unique_lock<std::mutex> lk(m_mtx_pipe);
+  while(1){
+    m_cv_in.wait(lk, [this](){return m_exit || !m_que_in.empty();});
+    if(m_que_in.empty())
+      return;
+    MonEvent me = std::move(m_que_in.front());
+    m_que_in.pop_front();
+    if(!m_simp_pool.empty()){
+      me.simpEv = std::move(m_simp_pool.back());
+      m_simp_pool.pop_back();
+    }
+    lk.unlock();
+
+    // a failed event is still handed on, the fill thread waits for every
+    // sequence number
+    try{
+      auto tp_start = std::chrono::steady_clock::now();
+      auto stdev = std::dynamic_pointer_cast<eudaq::StandardEvent>(me.ev);
+      if(!stdev){
+        // one StandardEvent per worker, its planes are refilled for each event
+        if(!stdev_buf)
+          stdev_buf = eudaq::StandardEvent::MakeShared();
+        else
+          stdev_buf->Recycle();
+        stdev = stdev_buf;
+        eudaq::StdEventConverter::Convert(me.ev, stdev, nullptr); //no conf
+      }
+      me.n_plane = stdev->NumPlanes();
+      if(me.simpEv)
+        me.simpEv->clear();
+      else
+        me.simpEv.reset(new SimpleStandardEvent);
+      BuildSimpleEvent(*stdev, *me.simpEv);
+      auto tp_cluster = std::chrono::steady_clock::now();
+      me.simpEv->doClustering();
+      auto tp_end = std::chrono::steady_clock::now();
+      me.analysis_time = std::chrono::duration<double>(tp_end - tp_start).count();
+      me.clustering_time = std::chrono::duration<double>(tp_end - tp_cluster).count();
+    }
+    catch(const std::exception &e){
+      std::cerr<< "OnlineMon:: event #"<< me.ev->GetEventN() <<" could not be analysed: "<< e.what() <<std::endl;
+      me.failed = true;
+      stdev_buf.reset();
+    }
+    catch(...){
+      std::cerr<< "OnlineMon:: event #"<< me.ev->GetEventN() <<" could not be analysed"<<std::endl;
+      me.failed = true;
+      stdev_buf.reset();
+    }
+    me.ev.reset();
+
+    lk.lock();
+    uint64_t seq = me.seq;
+    m_que_done[seq] = std::move(me);
+    m_cv_done.notify_all();
   }
-    
-  my_event_processing_time.Start(true);
+}
 
-  uint32_t num = stdev->NumPlanes();
+// histogram filling, on one thread and in the order the events came in
+void RootMonitor::Filling() {
+  std::unique_lock<std::mutex> lk(m_mtx_pipe);
+  while(1){
+    m_cv_done.wait(lk, [this](){
+	return m_que_done.count(m_seq_out) || (m_exit && m_seq_out == m_seq_in);});
+    auto it = m_que_done.find(m_seq_out);
+    if(it == m_que_done.end())
+      return;
+    MonEvent me = std::move(it->second);
+    m_que_done.erase(it);
+    lk.unlock();
+
+    std::unique_lock<std::mutex> lk_fill(m_mtx_fill);
+    bool skip = me.failed;
+    if(!skip && m_ev_rec_n < 10){
+      m_ev_rec_n ++;
+      if(me.n_plane > m_plane_c){
+        m_plane_c = me.n_plane;
+      }
+      skip = true;
+    }
+    else if(!skip && me.n_plane != m_plane_c){
+      std::cout<< "Event #"<< me.simpEv->getEvent_number()<< " has "<<me.n_plane<<" plane(s), while we expect "<< m_plane_c <<" plane(s).  (Event is skipped)" <<std::endl;
+      skip = true;
+    }
+    // DoReceive only queues the event, the prescale follows the time spent
+    // here and the workers' share of it
+    auto tp_start = std::chrono::steady_clock::now();
+    if(!skip){
+      previous_event_analysis_time = me.analysis_time;
+      previous_event_clustering_time = me.clustering_time;
+      try{
+        FillCollections(*me.simpEv);
+      }
+      catch(const std::exception &e){
+        std::cerr<< "OnlineMon:: event #"<< me.simpEv->getEvent_number() <<" could not be filled: "<< e.what() <<std::endl;
+      }
+      catch(...){
+        std::cerr<< "OnlineMon:: event #"<< me.simpEv->getEvent_number() <<" could not be filled"<<std::endl;
+      }
+    }
+    lk_fill.unlock();
+    AddBusyTime(std::chrono::duration<double>(std::chrono::steady_clock::now() - tp_start).count() +
+                me.analysis_time / m_n_worker);
+
+    // the sequence number is always advanced, WaitPipeline relies on it
+    lk.lock();
+    if(me.simpEv)
+      m_simp_pool.push_back(std::move(me.simpEv));
+    m_seq_out++;
+    m_cv_done.notify_all();
+    m_cv_space.notify_one();
+  }
+}
 
-  SimpleStandardEvent simpEv;
-  // store the processing time of the previous EVENT, as we can't track this during the  processing
-  simpEv.setMonitor_eventanalysistime(previous_event_analysis_time);
-  simpEv.setMonitor_eventfilltime(previous_event_fill_time);
-  simpEv.setMonitor_eventclusteringtime(previous_event_clustering_time);
-  simpEv.setMonitor_eventcorrelationtime(previous_event_correlation_time);
+void RootMonitor::BuildSimpleEvent(const eudaq::StandardEvent &stdev, SimpleStandardEvent &simpEv) {
+  uint32_t num = stdev.NumPlanes();
   // add some info into the simple event header
-  simpEv.setEvent_number(stdev->GetEventNumber());
-  simpEv.setEvent_timestamp(stdev->GetTimestampBegin());
+  simpEv.setEvent_number(stdev.GetEventNumber());
+  simpEv.setEvent_timestamp(stdev.GetTimestampBegin());
+  // numeric tags are shown by the ParaMonitorCollection
+  simpEv.setTags(stdev.GetTags());
     
   for (unsigned int i = 0; i < num;i++){
-    const eudaq::StandardPlane & plane = stdev->GetPlane(i);
+    const eudaq::StandardPlane & plane = stdev.GetPlane(i);
     
     string sensorname;
     if ((plane.Type() == std::string("DEPFET")) &&(plane.Sensor().length()==0)){ // FIXME ugly hack for the DEPFET
@@ -215,11 +386,25 @@ void RootMonitor::DoReceive(eudaq::EventSP evsp) {
     if (strcmp(plane.Sensor().c_str(), "FORTIS") == 0 ){
       continue;
     }
-    SimpleStandardPlane simpPlane(sensorname,plane.ID(),plane.XSize(),plane.YSize(),&mon_configdata);
-    for (unsigned int lvl1 = 0; lvl1 < plane.NumFrames(); lvl1++){
-      for (unsigned int index = 0; index < plane.HitPixels(lvl1);index++){
-        SimpleStandardHit hit((int)plane.GetX(index,lvl1),(int)plane.GetY(index,lvl1));
-        hit.setTOT((int)plane.GetPixel(index,lvl1)); //this stores the analog information if existent, else it stores 1
+    // the plane comes from the event's recycled storage, filled in place
+    SimpleStandardPlane &simpPlane = simpEv.addPlane(sensorname,plane.ID(),plane.XSize(),plane.YSize(),&mon_configdata);
+    const unsigned int nframes = plane.NumFrames();
+    const bool diffcoords = plane.GetFlags(eudaq::StandardPlane::FLAG_DIFFCOORDS);
+    size_t nhits = 0;
+    for (unsigned int lvl1 = 0; lvl1 < nframes; lvl1++)
+      nhits += plane.HitPixels(lvl1);
+    simpPlane.reserveHits(nhits);
+
+    for (unsigned int lvl1 = 0; lvl1 < nframes; lvl1++){
+      // walk the frame's vectors directly instead of GetX/GetY/GetPixel,
+      // which bounds check both indices for every pixel
+      const auto &vx = plane.XVector(diffcoords ? lvl1 : 0);
+      const auto &vy = plane.YVector(diffcoords ? lvl1 : 0);
+      const auto &vpix = plane.PixVector(lvl1);
+      const size_t n = std::min(vpix.size(), std::min(vx.size(), vy.size()));
+      for (size_t index = 0; index < n; index++){
+        SimpleStandardHit hit((int)vx[index],(int)vy[index]);
+        hit.setTOT((int)vpix[index]); //this stores the analog information if existent, else it stores 1
         hit.setLVL1(lvl1);
           
         if (simpPlane.getAnalogPixelType()){ //this is analog pixel, apply threshold
@@ -231,7 +416,9 @@ void RootMonitor::DoReceive(eudaq::EventSP evsp) {
           }
           if (simpPlane.is_EXPLORER){
             if (lvl1!=0) continue;
-            hit.setTOT((int)plane.GetPixel(index));
+            const auto &vresult = plane.PixVector();
+            if (index >= vresult.size()) continue;
+            hit.setTOT((int)vresult[index]);
             if (hit.getTOT() < 20){
               continue;
             }
@@ -243,21 +430,21 @@ void RootMonitor::DoReceive(eudaq::EventSP evsp) {
         }          
       }
     }
-    simpEv.addPlane(simpPlane);
   }
-  my_event_inner_operations_time.Start(true);
-  simpEv.doClustering();
-  my_event_inner_operations_time.Stop();
-  previous_event_clustering_time = my_event_inner_operations_time.RealTime();
+}
+
+void RootMonitor::FillCollections(SimpleStandardEvent &simpEv) {
+  // store the processing time of the previous EVENT, as we can't track this during the  processing
+  simpEv.setMonitor_eventanalysistime(previous_event_analysis_time);
+  simpEv.setMonitor_eventfilltime(previous_event_fill_time);
+  simpEv.setMonitor_eventclusteringtime(previous_event_clustering_time);
+  simpEv.setMonitor_eventcorrelationtime(previous_event_correlation_time);
 
   if(!_planesInitialized){
       std::this_thread::sleep_for(std::chrono::seconds(1));
       _planesInitialized = true;
   }
 
-  //stop the Stop watch
-  my_event_processing_time.Stop();
-  previous_event_analysis_time=my_event_processing_time.RealTime();
   //Filling
   my_event_processing_time.Start(true); //start the stopwatch again
   for (unsigned int i = 0 ; i < _colls.size(); ++i)
@@ -278,27 +465,43 @@ void RootMonitor::DoReceive(eudaq::EventSP evsp) {
         }
       else
         _colls.at(i)->Fill(simpEv);
-
-      // CollType is used to check which kind of Collection we are having
-      if (_colls.at(i)->getCollectionType()==HITMAP_COLLECTION_TYPE) // Calculate is only implemented for HitMapCollections
-        {
-          _colls.at(i)->Calculate(stdev->GetEventNumber());
-        }
     }
 
-  onlinemon->setEventNumber(stdev->GetEventNumber());
-  onlinemon->increaseAnalysedEventsCounter();
+  if (std::chrono::steady_clock::now() - m_last_update >= std::chrono::milliseconds(m_update_period))
+    UpdateCollections();
+  if (onlinemon){
+    onlinemon->setEventNumber(simpEv.getEvent_number());
+    onlinemon->increaseAnalysedEventsCounter();
+    onlinemon->PublishSnapshots();
+  }
+  if (m_snapshot_interval &&
+      std::chrono::steady_clock::now() - m_last_snapshot >= std::chrono::seconds(m_snapshot_interval))
+    WriteSnapshot();
     
   my_event_processing_time.Stop();
   previous_event_fill_time=my_event_processing_time.RealTime();
 }
 
 void RootMonitor::autoReset(const bool reset) {
-  onlinemon->setAutoReset(reset);
+  m_auto_reset = reset;
+  if (onlinemon)
+    onlinemon->setAutoReset(reset);
 }
 
 void RootMonitor::DoStopRun()
 {
+  WaitPipeline();
+  // events may still come in until the monitor stops listening
+  std::lock_guard<std::mutex> lk_fill(m_mtx_fill);
+  UpdateCollections();
+  if (onlinemon)
+    onlinemon->PublishSnapshots(true);
+  if (m_snapshot_interval)
+    WriteSnapshot();
+  if(m_drop_c)
+    std::cout<< m_drop_c <<" event(s) were dropped, the monitor could not keep up"<<std::endl;
+  if(GetSampleFraction() < 1)
+    std::cout<< "adaptive prescale: "<< GetSampleFraction() <<" of the received events were analysed"<<std::endl;
   m_plane_c = 0;
   m_ev_rec_n = 0;
 
@@ -311,17 +514,22 @@ void RootMonitor::DoStopRun()
     }
     f->Close();
   }
-  onlinemon->UpdateStatus("Run stopped");
+  if (onlinemon)
+    onlinemon->UpdateStatus("Run stopped");
 }
 
 void RootMonitor::DoStartRun() {
+  StartPipeline();
+  WaitPipeline();
   m_plane_c = 0;
   m_ev_rec_n = 0;
+  m_drop_c = 0;
   uint32_t runnumber = GetRunNumber();
 
-  if (onlinemon->getAutoReset())
+  if (m_auto_reset)
   {
-    onlinemon->UpdateStatus("Resetting..");
+    if (onlinemon)
+      onlinemon->UpdateStatus("Resetting..");
     for (unsigned int i = 0 ; i < _colls.size(); ++i)
     {
       if (_colls.at(i) != NULL)
@@ -329,19 +537,63 @@ void RootMonitor::DoStartRun() {
     }
   }
 
-  onlinemon->UpdateStatus("Starting run..");
   char out[255];
   sprintf(out, "run%d.root", runnumber);
   rootfilename = std::string(out);
-  onlinemon->setRunNumber(runnumber);
-  onlinemon->setRootFileName(rootfilename);
+  m_last_snapshot = std::chrono::steady_clock::now();
+  if (onlinemon){
+    onlinemon->UpdateStatus("Starting run..");
+    onlinemon->setRunNumber(runnumber);
+    onlinemon->setRootFileName(rootfilename);
+  }
 
   // Reset the planes initializer on new run start:
   _planesInitialized = false;
 }
 
 void RootMonitor::setUpdate(const unsigned int up) {
-  onlinemon->setUpdate(up);
+  m_update_period = up;
+  if (onlinemon)
+    onlinemon->setUpdate(up);
+}
+
+// write all collections every <sec> seconds while a run is going on, 0 disables
+void RootMonitor::setSnapshotInterval(const unsigned int sec) {
+  m_snapshot_interval = sec;
+}
+
+// plots computed from buffered data are only rebuilt at the update period
+void RootMonitor::UpdateCollections() {
+  m_last_update = std::chrono::steady_clock::now();
+  for (unsigned int i = 0 ; i < _colls.size(); ++i)
+  {
+    _colls.at(i)->Update();
+  }
+}
+
+// Called with the fill lock held, from the fill thread or from DoStopRun, so the
+// histograms do not change while they are written. The file is renamed into
+// place once complete, a remote reader never sees a half written snapshot.
+void RootMonitor::WriteSnapshot() {
+  m_last_snapshot = std::chrono::steady_clock::now();
+  UpdateCollections();
+  std::string name = snapshotdir + "snapshot_" + rootfilename;
+  std::string tmpname = name + ".tmp";
+  TDirectory::TContext ctx;
+  TFile *f = new TFile(tmpname.c_str(), "RECREATE");
+  if (f->IsZombie()){
+    std::cerr<< "OnlineMon:: unable to write snapshot "<< tmpname <<std::endl;
+    delete f;
+    return;
+  }
+  for (unsigned int i = 0 ; i < _colls.size(); ++i)
+  {
+    _colls.at(i)->Write(f);
+  }
+  f->Close();
+  delete f;
+  if (std::rename(tmpname.c_str(), name.c_str()) != 0)
+    std::cerr<< "OnlineMon:: unable to move snapshot to "<< name <<std::endl;
 }
 
 //sets the location for the snapshots
@@ -389,8 +641,11 @@ int main(int argc, const char ** argv) {
   eudaq::Option<int>             reduce(op, "rd", "reduce",  1, "Reduce the number of events");
   eudaq::Option<unsigned>        corr_width(op, "cw", "corr_width",500, "Width of the track correlation window");
   eudaq::Option<unsigned>        corr_planes(op, "cp", "corr_planes",  5, "Minimum amount of planes for track reconstruction in the correlation");
+  eudaq::Option<unsigned>        corr_missing(op, "cm", "corr_missing",  0, "Number of planes a track may skip in the track correlation");
   eudaq::Option<bool>            track_corr(op, "tc", "track_correlation", false, "Using (EXPERIMENTAL) track correlation(true) or cluster correlation(false)");
   eudaq::Option<int>             update(op, "u", "update",  1000, "update every ms");
+  eudaq::Option<double>          target_load(op, "tl", "target_load", 0., "fraction of the time the monitor may spend on incoming events, lower rates are sampled adaptively (0 = off)");
+  eudaq::Option<unsigned>        workers(op, "j", "workers", std::max(1u, std::thread::hardware_concurrency()/2), "number of threads converting and clustering events");
   eudaq::Option<uint32_t>        event_id_low(op, "e", "event_id_low",  0, "running is offlinemode - analyse begin event id <num>");
   eudaq::Option<uint32_t>        event_id_high(op, "E", "event_id_high", 0xffffffff, "running is offlinemode - analyse until event id <num>");
   eudaq::Option<uint32_t>        event_amount_max(op, "ea", "event_amount_max", 0xffffffff, "running is offlinemode - analyse until reach events amount");
@@ -400,6 +655,8 @@ int main(int argc, const char ** argv) {
   eudaq::Option<std::string>     monitorname(op, "t", "monitor_name","StdEventMonitor", "StdEventMonitor","Name for onlinemon");	
   eudaq::OptionFlag do_rootatend (op, "rf","root","Write out root-file after each run");
   eudaq::OptionFlag do_resetatend (op, "rs","reset","Reset Histograms when run stops");
+  eudaq::OptionFlag do_headless (op, "hl","headless","Run without GUI, the histograms are written to snapshot files only");
+  eudaq::Option<unsigned>        snapshot_interval(op, "si", "snapshot_interval", 0, "seconds", "Write all histograms to <SnapShotDir>/snapshot_run<N>.root every <seconds> (headless default 10)");
   
   try {
     op.Parse(argv);
@@ -416,17 +673,30 @@ int main(int argc, const char ** argv) {
   if(!rctrl.IsSet())
     rctrl.SetValue("tcp://localhost:44000");
     
-  TApplication theApp("App", &argc, const_cast<char**>(argv),0,0);
+  bool headless = do_headless.IsSet();
+  std::unique_ptr<TApplication> theApp;
+  if(headless)
+    gROOT->SetBatch(kTRUE);
+  else
+    theApp.reset(new TApplication("App", &argc, const_cast<char**>(argv),0,0));
   RootMonitor mon(rctrl.Value(),
 		  100, 0, 1400, 700,
-                  configfile.Value(), monitorname.Value());
+                  configfile.Value(), monitorname.Value(), headless);
   mon.setWriteRoot(do_rootatend.IsSet());
   mon.autoReset(do_resetatend.IsSet());
   mon.setReduce(reduce.Value());
   mon.setUpdate(update.Value());
   mon.setCorr_width(corr_width.Value());
   mon.setCorr_planes(corr_planes.Value());
+  mon.setCorr_missing(corr_missing.Value());
   mon.setUseTrack_corr(track_corr.Value());
+  mon.setWorkers(workers.Value());
+  mon.SetTargetLoad(target_load.Value());
+  mon.setBlocking(offline);
+  if(snapshot_interval.IsSet())
+    mon.setSnapshotInterval(snapshot_interval.Value());
+  else if(headless)
+    mon.setSnapshotInterval(10);
   eudaq::Monitor *m = dynamic_cast<eudaq::Monitor*>(&mon);
   std::future<uint64_t> fut_async_rd;
 
@@ -443,7 +713,13 @@ int main(int argc, const char ** argv) {
     m->Connect();
   }
 
-  theApp.Run(); //execute
+  if(!headless)
+    theApp->Run(); //execute
+  else if(!offline){
+    while(m->IsConnected()){
+      std::this_thread::sleep_for(std::chrono::seconds(1));
+    }
+  }
   if(fut_async_rd.valid())
     fut_async_rd.get();
   return 0;
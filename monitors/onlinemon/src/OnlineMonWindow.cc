@@ -34,8 +34,8 @@ using namespace std;
 
 // the constructor
 OnlineMonWindow::OnlineMonWindow(const TGWindow *p, UInt_t w, UInt_t h)
-    : TGMainFrame(p, w, h, kVerticalFrame), _eventnum(0), _runnum(0),
-      _analysedEvents(0) {
+    : TGMainFrame(p, w, h, kVerticalFrame), _snapshotPeriod(1000),
+      _eventnum(0), _runnum(0), _analysedEvents(0) {
 
   // init snapshot counter
   snapshot_sequence = 0;
@@ -336,10 +336,56 @@ void OnlineMonWindow::registerMutex(std::string tree, std::mutex *m){
   _mutexMap[tree] = m;
 }
 
+// Called by the thread filling the histograms. Copies the displayed
+// histograms at most once per update period; if the GUI is drawing at that
+// moment the copy is simply done after a later event.
+void OnlineMonWindow::PublishSnapshots(bool force) {
+  auto now = std::chrono::steady_clock::now();
+  if (!force && now - _lastSnapshot < std::chrono::milliseconds(_snapshotPeriod))
+    return;
+  std::unique_lock<std::mutex> lk(_snapshotMutex, std::defer_lock);
+  if (force)
+    lk.lock();
+  else if (!lk.try_lock())
+    return;
+  _lastSnapshot = now;
+  for (const auto &tree : _snapshotList) {
+    auto it = _hitmapMap.find(tree);
+    if (it == _hitmapMap.end() || !it->second)
+      continue;
+    std::unique_lock<std::mutex> lk_histo;
+    auto itmu = _mutexMap.find(tree);
+    if (itmu != _mutexMap.end())
+      lk_histo = std::unique_lock<std::mutex>(*itmu->second);
+    TNamed *&snap = _snapshotMap[tree];
+    TH1 *h = dynamic_cast<TH1 *>(it->second);
+    TGraph *g = dynamic_cast<TGraph *>(it->second);
+    if (h) {
+      if (!snap) {
+        TH1 *hs = dynamic_cast<TH1 *>(h->Clone());
+        hs->SetDirectory(0);
+        snap = hs;
+      } else {
+        // Copy also takes over the directory of h, keep the snapshot detached
+        h->Copy(*snap);
+        static_cast<TH1 *>(snap)->SetDirectory(0);
+      }
+    } else if (g) {
+      if (!snap)
+        snap = dynamic_cast<TGraph *>(g->Clone());
+      else
+        *static_cast<TGraph *>(snap) = *g;
+    }
+  }
+}
+
 void OnlineMonWindow::autoUpdate() {
   _reduceUpdate++;
   unsigned int activeHistoSize = _activeHistos.size();
   if (activeHistoSize && _reduceUpdate > activeHistoSize){
+    std::lock_guard<std::mutex> lk_snap(_snapshotMutex);
+    if (_snapshotList != _activeHistos)
+      _snapshotList = _activeHistos;
     TCanvas *fCanvas = ECvs_right->GetCanvas();
     for (unsigned int i = 0; i < activeHistoSize; ++i) {
       if(activeHistoSize ==1){
@@ -351,13 +397,18 @@ void OnlineMonWindow::autoUpdate() {
 	fCanvas->cd(i + 1);
       }
       std::string tree = _activeHistos.at(i);
-      TNamed *hg = _hitmapMap[tree];
+      // nothing published yet, e.g. no data since the selection: fall back
+      // to the live histogram under its own lock
+      TNamed *hg = _snapshotMap[tree];
+      bool live = !hg;
+      if (live)
+        hg = _hitmapMap[tree];
       if(hg) {
 	TH1 *h = dynamic_cast<TH1 *> (hg);
 	std::mutex mu_dummy;
 	std::mutex *mu = &mu_dummy;
 	auto it = _mutexMap.find(tree);
-	if(it != _mutexMap.end())
+	if(live && it != _mutexMap.end())
 	  mu=it->second;
 	if(h){
 	  std::lock_guard<std::mutex> lck(*mu);
@@ -382,7 +433,6 @@ void OnlineMonWindow::autoUpdate() {
   }
 }
 
-
 void OnlineMonWindow::ChangeReduce(Long_t /*num*/) {
   _reduce = (unsigned int)(nen_reduce->GetNumber());
   for (unsigned int i = 0; i < _colls.size(); ++i) {
@@ -507,6 +557,7 @@ void OnlineMonWindow::setAutoReset(bool reset) {
 }
 
 void OnlineMonWindow::setUpdate(const unsigned int up) {
+  _snapshotPeriod = up;
   timer->Stop();
   timer->Start(up, kFALSE);
 }
@@ -1,10 +1,11 @@
 
 #include "ParaMonitorCollection.hh"
 #include "OnlineMon.hh"
+#include <cstdlib>
 
 ParaMonitorCollection::ParaMonitorCollection()
   : BaseCollection(){
-  histos_init = false;
+  m_col_time = m_ring.addColumn("time");
   cout << " Initialising ParaMonitor Collection" << endl;
   CollectionType = PARAMONITOR_COLLECTION_TYPE;
 
@@ -18,21 +19,22 @@ ParaMonitorCollection::~ParaMonitorCollection() {
   m_graphMap.clear();
 }
 
-void ParaMonitorCollection::InitPlots(const SimpleStandardEvent &simpev){
-  std::string name;
-  TGraph *tg;
-  std::vector<std::string> list = simpev.getSlowList();
-  for(auto &e: list){
-    name = e;
-    tg = new TGraph();
-    // tg->SetMarkerStyle(5);
-    // tg->SetMarkerSize(4);
-    tg->SetTitle(name.c_str());
-    m_graphMap[name] = tg;    
+void ParaMonitorCollection::addPlot(const std::string &name){
+  TGraph *tg = new TGraph();
+  tg->SetTitle(name.c_str());
+  {
+    std::lock_guard<std::mutex> lck(m_mu);
+    m_graphMap[name] = tg;
+  }
+  if (_mon != NULL && _mon->getOnlineMon() != NULL) {
+    string folder_name = "Paramater Monitor";
+    std::string tree = folder_name+"/"+name;
+    _mon->getOnlineMon()->registerTreeItem(tree);
+    _mon->getOnlineMon()->registerHisto(tree,tg);
+    _mon->getOnlineMon()->registerMutex(tree,&m_mu);
+    _mon->getOnlineMon()->makeTreeItemSummary(
+        folder_name.c_str()); // make summary page
   }
-  
-  if(m_graphMap.size())
-    histos_init = true;
 }
 
 
@@ -56,41 +58,67 @@ void ParaMonitorCollection::Calculate(
     const unsigned int /*currentEventNumber*/) {}
 
 void ParaMonitorCollection::Reset() {
+  {
+    std::lock_guard<std::mutex> lck(m_mu);
     for(auto &e: m_graphMap){
       e.second->Set(0);
     }
+  }
+  std::lock_guard<std::mutex> lck_ring(*m_ring.getMutex());
+  m_ring.clear();
+  m_pending.clear();
 }
 
-void ParaMonitorCollection::Fill(const SimpleStandardEvent &simpev) {
-  // This means we can't change the plots as we go, maybe OK?
-  if (histos_init == false) {
-    InitPlots(simpev);
-    bookHistograms(simpev);
+void ParaMonitorCollection::Update() {
+  std::vector<double> time;
+  std::lock_guard<std::mutex> lck_ring(*m_ring.getMutex());
+  // one row per tagged event, the parsing is all that waits for the update
+  for(auto &p: m_pending){
+    m_ring.newRow();
+    m_ring.set(m_col_time, p.first);
+    for(auto &e: p.second){
+      const char *begin = e.second.c_str();
+      char *end = nullptr;
+      double value = std::strtod(begin, &end);
+      if (end == begin || *end != '\0')
+        continue;
+      if (!m_graphMap.count(e.first))
+        addPlot(e.first);
+      m_ring.set(m_ring.addColumn(e.first), value);
+    }
   }
-  unsigned int clkpersec = 48000000*8;
+  m_pending.clear();
+  m_ring.getColumn(m_col_time, time);
   for(auto &e: m_graphMap){
-    double value;
-    std::string str = e.first;
-    if(simpev.getSlow_para(str, value)){
-      TGraph *tg=e.second;
-      std::lock_guard<std::mutex> lck(m_mu);
-      tg->SetPoint(tg->GetN(), simpev.getEvent_timestamp()/clkpersec, value);
+    int col = m_ring.findColumn(e.first);
+    if(col < 0)
+      continue;
+    m_ring.getColumn(col, m_buf_y);
+    // an update without this parameter has NaN in its column
+    m_buf_x.clear();
+    size_t n = 0;
+    for(size_t i = 0; i < m_buf_y.size(); i++){
+      if(m_buf_y[i] != m_buf_y[i])
+        continue;
+      m_buf_x.push_back(time[i]);
+      m_buf_y[n++] = m_buf_y[i];
     }
+    TGraph *tg = e.second;
+    std::lock_guard<std::mutex> lck(m_mu);
+    tg->Set(n);
+    for(size_t i = 0; i < n; i++)
+      tg->SetPoint(i, m_buf_x[i], m_buf_y[i]);
   }
-  
 }
 
-void ParaMonitorCollection::bookHistograms(
-    const SimpleStandardEvent & /*simpev*/) {
-  if (_mon != NULL) {
-    string folder_name = "Paramater Monitor";
-    for(auto &e: m_graphMap){
-      std::string name = folder_name+"/"+e.first;
-      _mon->getOnlineMon()->registerTreeItem(name);
-      _mon->getOnlineMon()->registerHisto(name,e.second);
-      _mon->getOnlineMon()->registerMutex(name,&m_mu);
-    }
-    _mon->getOnlineMon()->makeTreeItemSummary(
-        folder_name.c_str()); // make summary page
-  }
+void ParaMonitorCollection::Fill(const SimpleStandardEvent &simpev) {
+  const std::map<std::string, std::string> &tags = simpev.getTags();
+  if (tags.empty())
+    return;
+  unsigned int clkpersec = 48000000*8;
+  std::lock_guard<std::mutex> lck_ring(*m_ring.getMutex());
+  // rows older than the ring holds would be overwritten anyway
+  if (m_pending.size() >= m_ring.getCapacity())
+    m_pending.pop_front();
+  m_pending.emplace_back(simpev.getEvent_timestamp()/clkpersec, tags);
 }
@@ -0,0 +1,60 @@
+/*
+ * ScalarRing.cc
+ *
+ * Column store for per-event numbers, used for the trend plots.
+ */
+
+#include <limits>
+#include "include/ScalarRing.hh"
+
+ScalarRing::ScalarRing(size_t capacity)
+    : _capacity(capacity ? capacity : 1), _last(0), _nRows(0), _nTotal(0) {}
+
+size_t ScalarRing::addColumn(const std::string &name) {
+  int col = findColumn(name);
+  if (col >= 0)
+    return col;
+  _names.push_back(name);
+  _columns.push_back(
+      std::vector<double>(_capacity, std::numeric_limits<double>::quiet_NaN()));
+  return _names.size() - 1;
+}
+
+int ScalarRing::findColumn(const std::string &name) const {
+  for (size_t i = 0; i < _names.size(); i++)
+    if (_names[i] == name)
+      return i;
+  return -1;
+}
+
+void ScalarRing::newRow() {
+  if (_nTotal)
+    _last = (_last + 1) % _capacity;
+  _nTotal++;
+  if (_nRows < _capacity)
+    _nRows++;
+  for (auto &column : _columns)
+    column[_last] = std::numeric_limits<double>::quiet_NaN();
+}
+
+void ScalarRing::set(size_t col, double value) {
+  if (_nRows && col < _columns.size())
+    _columns[col][_last] = value;
+}
+
+void ScalarRing::clear() {
+  _last = 0;
+  _nRows = 0;
+  _nTotal = 0;
+}
+
+void ScalarRing::getColumn(size_t col, std::vector<double> &out) const {
+  out.clear();
+  if (col >= _columns.size())
+    return;
+  const std::vector<double> &column = _columns[col];
+  out.reserve(_nRows);
+  size_t first = (_last + _capacity + 1 - _nRows) % _capacity;
+  for (size_t i = 0; i < _nRows; i++)
+    out.push_back(column[(first + i) % _capacity]);
+}
@@ -7,26 +7,74 @@
 
 
 // constructor, reserve some planes and initialize all variables
-SimpleStandardEvent::SimpleStandardEvent() {
+SimpleStandardEvent::SimpleStandardEvent() : _nPlanes(0) {
   _planes.reserve(20);
+  clear();
+}
+
+// forget the planes of the last event, but keep them to be refilled
+void SimpleStandardEvent::clear() {
+  _nPlanes = 0;
   monitor_eventfilltime = 0;
   monitor_eventanalysistime = 0;
   monitor_clusteringtime = 0;
   monitor_correlationtime = 0;
   event_number = 0;
   event_timestamp = 0;
+  slowpara.clear();
+  _tags.clear();
 }
 
 void SimpleStandardEvent::addPlane(SimpleStandardPlane &plane) {
   // Checks if plane with same name and id is registered already
   bool found = false;
-  for (unsigned int i = 0; i < _planes.size(); ++i) {
+  for (int i = 0; i < _nPlanes; ++i) {
     if (_planes.at(i) == plane)
       found = true;
   }
   if (found)
     plane.addSuffix("-2");
-  _planes.push_back(plane);
+  if (_nPlanes < (int)_planes.size())
+    _planes[_nPlanes] = plane;
+  else
+    _planes.push_back(plane);
+  _nPlanes++;
+}
+
+void SimpleStandardEvent::addPlane(SimpleStandardPlane &&plane) {
+  bool found = false;
+  for (int i = 0; i < _nPlanes; ++i) {
+    if (_planes.at(i) == plane)
+      found = true;
+  }
+  if (found)
+    plane.addSuffix("-2");
+  if (_nPlanes < (int)_planes.size())
+    _planes[_nPlanes] = std::move(plane);
+  else
+    _planes.push_back(std::move(plane));
+  _nPlanes++;
+}
+
+// Adds an empty plane, reusing the storage of a plane from an earlier event
+// when there is one.
+SimpleStandardPlane &
+SimpleStandardEvent::addPlane(const std::string &name, const int id,
+                              const int maxX, const int maxY,
+                              OnlineMonConfiguration *mymon) {
+  bool found = false;
+  for (int i = 0; i < _nPlanes; ++i) {
+    if (_planes[i].getName() == name && _planes[i].getID() == id)
+      found = true;
+  }
+  if (_nPlanes < (int)_planes.size())
+    _planes[_nPlanes].reset(name, id, maxX, maxY, mymon);
+  else
+    _planes.push_back(SimpleStandardPlane(name, id, maxX, maxY, mymon));
+  SimpleStandardPlane &plane = _planes[_nPlanes++];
+  if (found)
+    plane.addSuffix("-2");
+  return plane;
 }
 double SimpleStandardEvent::getMonitor_eventanalysistime() const {
   return monitor_eventanalysistime;
@@ -8,20 +8,36 @@
 #include <string>
 #include <vector>
 #include "include/SimpleStandardPlane.hh"
+#include "eudaq/Clusterizer.hh"
 
 SimpleStandardPlane::SimpleStandardPlane(const std::string &name, const int id,
                                          const int maxX, const int maxY,
-                                         OnlineMonConfiguration *mymon)
-    : _name(name), _id(id), _maxX(maxX), _maxY(maxY), _binsX(maxX),
-      _binsY(maxY) {
+                                         OnlineMonConfiguration *mymon) {
   const int hits_reserve = 500;
   _hits.reserve(hits_reserve);
   _badhits.reserve(hits_reserve); // allocate memory
   _clusters.reserve(hits_reserve);
-  _rawhits.reserve(hits_reserve);
+  reset(name, id, maxX, maxY, mymon);
+}
+
+// Makes the plane ready for the next event. The hit and cluster vectors are
+// cleared but keep their memory, so a recycled plane does not allocate.
+void SimpleStandardPlane::reset(const std::string &name, const int id,
+                                const int maxX, const int maxY,
+                                OnlineMonConfiguration *mymon) {
+  _name = name;
+  _id = id;
+  _maxX = maxX;
+  _maxY = maxY;
+  _binsX = maxX;
+  _binsY = maxY;
+  _hits.clear();
+  _badhits.clear();
+  _rawhits.clear();
+  _clusters.clear();
   for (int i = 0; i < 4; i++) {
-    _section_hits[i].reserve(hits_reserve); // FIXME hard-coded for Mimosa
-    _section_clusters[i].reserve(hits_reserve);
+    _section_nhits[i] = 0;
+    _section_nclusters[i] = 0;
   }
 
   mon = mymon;
@@ -47,6 +63,10 @@ SimpleStandardPlane::SimpleStandardPlane(const std::string &name, const int id)
   _hits.reserve(400);
   _badhits.reserve(400); //
   _clusters.reserve(40);
+  for (int i = 0; i < 4; i++) {
+    _section_nhits[i] = 0;
+    _section_nclusters[i] = 0;
+  }
   mon = NULL; // no monitor given
   AnalogPixelType = false; // per default these are digital pixel planes
   // init these settings
@@ -64,7 +84,7 @@ SimpleStandardPlane::SimpleStandardPlane(const std::string &name, const int id)
   _binsY = -1;
 }
 
-void SimpleStandardPlane::addHit(SimpleStandardHit oneHit) {
+void SimpleStandardPlane::addHit(const SimpleStandardHit &oneHit) {
   // oneHit.reduce(_binsX, _binsY); //also fills the appropriate sections
   // //FIXME a better definition of badhits is needed
 
@@ -77,16 +97,17 @@ void SimpleStandardPlane::addHit(SimpleStandardHit oneHit) {
 
   if (is_MIMOSA26) {
     int section = oneHit.getX() / mon->getMimosa26_section_boundary();
-    if ((section < 0) || (section >= (int)mon->getMimosa26_max_sections())) {
+    if ((section < 0) || (section >= (int)mon->getMimosa26_max_sections()) ||
+        (section >= 4)) {
       std::cout << "Error Section invalid: " << section << " " << oneHit.getX()
                 << " " << oneHit.getY() << std::endl;
     } else {
-      _section_hits[section].push_back(oneHit);
+      _section_nhits[section]++;
     }
   }
 }
 
-void SimpleStandardPlane::addRawHit(SimpleStandardHit oneHit) {
+void SimpleStandardPlane::addRawHit(const SimpleStandardHit &oneHit) {
   _rawhits.push_back(oneHit);
 }
 
@@ -96,88 +117,28 @@ void SimpleStandardPlane::reducePixels(const int reduceX, const int reduceY) {
 }
 
 void SimpleStandardPlane::doClustering() {
-  int nClusters = 0;
-  std::vector<int> clusterNumber;
-  const int NOCLUSTER = -1000;
-  const unsigned int minXDistance = 1;
-  const unsigned int minYDistance = 1;
-  const unsigned int npixels_hit = _hits.size();
-  bool continue_flag;
-  clusterNumber.assign(npixels_hit, NOCLUSTER);
-
   // which planes to cluster, reject planes of Type Fortis
   if (is_FORTIS) {
     return;
   }
 
-  if (npixels_hit > 1) // (npixels_hit < 2000 ))
-  {
-    std::sort(_hits.begin(), _hits.end(), SortHitsByXY());
-    for (unsigned int aPixel = 0; aPixel < npixels_hit; aPixel++) {
-      continue_flag = true;
-      const SimpleStandardHit &aPix = _hits.at(aPixel);
-      for (unsigned int bPixel = aPixel + 1; bPixel < npixels_hit; bPixel++) {
-        if (continue_flag != true)
-          break;
-        const SimpleStandardHit &bPix = _hits.at(bPixel);
-        unsigned int xDist = abs(aPix.getX() - bPix.getX());
-        unsigned int yDist = abs(aPix.getY() - bPix.getY());
-
-        if ((xDist <= minXDistance) &&
-            (yDist <= minYDistance)) { // this means they are neighbors in
-                                       // x-direction && / this means they are
-                                       // neighbors in y-direction
-          if ((clusterNumber.at(aPixel) == NOCLUSTER) &&
-              clusterNumber.at(bPixel) == NOCLUSTER) { // none of these pixels
-                                                       // have been assigned to
-                                                       // a cluster
-            //++nClusters;
-            clusterNumber.at(aPixel) = ++nClusters;
-            clusterNumber.at(bPixel) = nClusters;
-          } else if ((clusterNumber.at(aPixel) == NOCLUSTER) &&
-                     (clusterNumber.at(bPixel) !=
-                      NOCLUSTER)) { // b was assigned already, a not
-            clusterNumber.at(aPixel) = clusterNumber.at(bPixel);
-          } else if ((clusterNumber.at(aPixel) != NOCLUSTER) &&
-                     (clusterNumber.at(bPixel) ==
-                      NOCLUSTER)) { // a was assigned already, b not
-            clusterNumber.at(bPixel) = clusterNumber.at(aPixel);
-          } else { // both pixels have a cluster number already
-            int min =
-                std::min(clusterNumber.at(aPixel), clusterNumber.at(bPixel));
-            clusterNumber.at(aPixel) = min;
-            clusterNumber.at(bPixel) = min;
-          }
-        } else { // these pixels are not neighbored
-          continue_flag = false;
-        }
-      } // inner for loop
-    } // outer for loop
-    for (unsigned int aPixel = 0; aPixel < npixels_hit; aPixel++)
-      if (clusterNumber.at(aPixel) == NOCLUSTER) {
-        ++nClusters;
-        clusterNumber.at(aPixel) = nClusters;
-      }
-  } else { // You can't use the clustering algorithm with only one pixel
-    if (npixels_hit == 1)
-      clusterNumber.at(0) = 1;
-  }
-
-  std::set<int> clusterSet(clusterNumber.begin(), clusterNumber.end());
-
-  nClusters = clusterSet.size();
-
-  std::set<int>::iterator it;
-  for (it = clusterSet.begin(); it != clusterSet.end(); ++it) {
+  // one clusterizer per thread, its buffers are reused for every plane
+  static thread_local eudaq::Clusterizer clusterizer;
+  clusterizer.Clear();
+  // the hits stay sorted by x and y for the later fills, as before
+  std::sort(_hits.begin(), _hits.end(), SortHitsByXY());
+  for (const auto &hit : _hits)
+    clusterizer.AddPixel(hit.getX(), hit.getY());
+  const size_t nClusters = clusterizer.Run();
+
+  const std::vector<uint32_t> &order = clusterizer.GetOrder();
+  const std::vector<uint32_t> &offsets = clusterizer.GetOffsets();
+  _clusters.reserve(_clusters.size() + nClusters);
+  for (size_t c = 0; c < nClusters; c++) {
     SimpleStandardCluster cluster;
-    for (unsigned int i = 0; i < npixels_hit; i++) {
-      if (clusterNumber.at(i) == *it) { // Put only these pixels in that
-                                        // ClusterCollection that belong to that
-                                        // cluster
-        cluster.addPixel(_hits.at(i));
-      }
-    }
-    _clusters.push_back(cluster);
+    for (uint32_t k = offsets[c]; k < offsets[c + 1]; k++)
+      cluster.addPixel(_hits[order[k]]);
+    _clusters.push_back(std::move(cluster));
   }
   // if we have a mimosa, we need to fill the section information
 
@@ -186,9 +147,10 @@ void SimpleStandardPlane::doClustering() {
          mycluster++) {
       unsigned int cluster_section =
           _clusters[mycluster].getX() / mon->getMimosa26_section_boundary();
-      if (cluster_section < mon->getMimosa26_max_sections()) // fixme
+      if (cluster_section < mon->getMimosa26_max_sections() &&
+          cluster_section < 4) // fixme
       {
-        _section_clusters[cluster_section].push_back(_clusters[mycluster]);
+        _section_nclusters[cluster_section]++;
       }
     }
   }
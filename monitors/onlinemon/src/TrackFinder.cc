@@ -0,0 +1,94 @@
+/*
+ * TrackFinder.cc
+ *
+ * Road search used for the track based correlation plots.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include "include/TrackFinder.hh"
+
+TrackFinder::TrackFinder()
+    : _nPlanes(0), _window(0), _minPlanes(0), _maxMissingPlanes(0) {}
+
+void TrackFinder::clear() {
+  _nPlanes = 0;
+  _tracks.clear();
+}
+
+void TrackFinder::addPlane(int plane, bool correlate,
+                           const std::vector<SimpleStandardCluster> &clusters,
+                           int minSeedSize) {
+  if (_nPlanes == _planes.size())
+    _planes.push_back(Plane());
+  Plane &p = _planes[_nPlanes++];
+  p.index = plane;
+  p.correlate = correlate;
+  p.candidates.clear();
+  for (const auto &cluster : clusters) {
+    // single pixel clusters are not used for tracking
+    if (cluster.getNPixel() == 1)
+      continue;
+    p.candidates.push_back(Candidate{cluster.getX(), cluster.getY(), &cluster,
+                                     cluster.getNPixel() >= minSeedSize,
+                                     false});
+  }
+  std::sort(p.candidates.begin(), p.candidates.end(),
+            [](const Candidate &l, const Candidate &r) { return l.x < r.x; });
+}
+
+TrackFinder::Candidate *TrackFinder::findClosest(Plane &plane,
+                                                 const Candidate &last) {
+  auto it = std::lower_bound(
+      plane.candidates.begin(), plane.candidates.end(), last.x - _window + 1,
+      [](const Candidate &c, int x) { return c.x < x; });
+  Candidate *best = NULL;
+  int bestDist = 0;
+  for (; it != plane.candidates.end() && it->x < last.x + _window; ++it) {
+    int dy = std::abs(it->y - last.y);
+    if (it->used || dy >= _window)
+      continue;
+    int dist = std::abs(it->x - last.x) + dy;
+    if (!best || dist < bestDist) {
+      best = &*it;
+      bestDist = dist;
+    }
+  }
+  return best;
+}
+
+const std::vector<TrackFinder::Track> &TrackFinder::findTracks() {
+  for (unsigned int seedPlane = 0; seedPlane < _nPlanes; seedPlane++) {
+    if (_nPlanes - seedPlane < _minPlanes)
+      break;
+    for (auto &seed : _planes[seedPlane].candidates) {
+      if (seed.used || !seed.seed)
+        continue;
+      _trackCandidates.clear();
+      _trackCandidates.push_back(&seed);
+      _track.clear();
+      _track.push_back(TrackPoint{_planes[seedPlane].index, seed.cluster});
+      unsigned int lastPlane = seedPlane;
+      unsigned int missing = 0;
+      for (unsigned int next = seedPlane + 1; next < _nPlanes; next++) {
+        Candidate *found = NULL;
+        if (_planes[lastPlane].correlate && _planes[next].correlate)
+          found = findClosest(_planes[next], *_trackCandidates.back());
+        if (found) {
+          _trackCandidates.push_back(found);
+          _track.push_back(TrackPoint{_planes[next].index, found->cluster});
+          lastPlane = next;
+          missing = 0;
+        } else if (++missing > _maxMissingPlanes) {
+          break;
+        }
+      }
+      if (_track.size() < _minPlanes || _track.size() < 2)
+        continue;
+      for (auto cand : _trackCandidates)
+        cand->used = true;
+      _tracks.push_back(_track);
+    }
+  }
+  return _tracks;
+}
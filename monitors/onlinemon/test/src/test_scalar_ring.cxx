@@ -0,0 +1,56 @@
+#include "include/ScalarRing.hh"
+#include "TestCheck.hh"
+
+#include <vector>
+
+namespace{
+  bool IsNaN(double v){return v != v;}
+}
+
+int main(){
+  ScalarRing ring(4);
+  size_t a = ring.addColumn("a");
+  EUDAQ_CHECK(ring.addColumn("a") == a);
+  EUDAQ_CHECK(ring.findColumn("b") < 0);
+  std::vector<double> out;
+  ring.getColumn(a, out);
+  EUDAQ_CHECK(out.empty());
+
+  // a value set before the first row goes nowhere
+  ring.set(a, 1.);
+  EUDAQ_CHECK(ring.getNRows() == 0);
+
+  for(int i = 0; i < 3; i++){
+    ring.newRow();
+    ring.set(a, i);
+  }
+  // a column added later reads NaN for the earlier rows
+  size_t b = ring.addColumn("b");
+  ring.set(b, 10.);
+  ring.getColumn(b, out);
+  EUDAQ_CHECK(out.size() == 3 && IsNaN(out[0]) && IsNaN(out[1]) && out[2] == 10.);
+
+  // once full, the oldest rows are overwritten; oldest row first
+  for(int i = 3; i < 7; i++){
+    ring.newRow();
+    ring.set(a, i);
+  }
+  EUDAQ_CHECK(ring.getNRows() == 4);
+  EUDAQ_CHECK(ring.getNTotal() == 7);
+  ring.getColumn(a, out);
+  EUDAQ_CHECK(out == std::vector<double>({3., 4., 5., 6.}));
+  ring.getColumn(b, out);
+  EUDAQ_CHECK(out.size() == 4);
+  for(auto v: out)
+    EUDAQ_CHECK(IsNaN(v));
+
+  ring.clear();
+  EUDAQ_CHECK(ring.getNRows() == 0 && ring.getNTotal() == 0);
+  EUDAQ_CHECK(ring.getNColumns() == 2);
+  ring.newRow();
+  ring.set(a, 8.);
+  ring.getColumn(a, out);
+  EUDAQ_CHECK(out == std::vector<double>({8.}));
+  EUDAQ_CHECK(ring.getCapacity() == 4);
+  return 0;
+}
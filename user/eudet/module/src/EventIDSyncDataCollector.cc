@@ -61,7 +61,8 @@ namespace eudaq {
         n++;
     }
     if(n==m_que_event.size()){
-      auto ev_wrap = Event::MakeUnique("EventIDSyncOnline");
+      static constexpr uint32_t dspt_hash = cstr2hash("EventIDSyncOnline");
+      auto ev_wrap = Event::MakeUnique("EventIDSyncOnline", dspt_hash);
       ev_wrap->SetFlagPacket();
       uint32_t ev_c = m_que_event.begin()->second.front()->GetEventN();
       bool match = true;
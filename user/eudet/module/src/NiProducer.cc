@@ -45,7 +45,8 @@ void NiProducer::RunLoop(){
     if(!ni_control->DataTransportClientSocket_Select()){
       continue;
     }
-    auto evup = eudaq::Event::MakeUnique("NiRawDataEvent");
+    static constexpr uint32_t dspt_hash = eudaq::cstr2hash("NiRawDataEvent");
+    auto evup = eudaq::Event::MakeUnique("NiRawDataEvent", dspt_hash);
     uint32_t datalength1 = ni_control->DataTransportClientSocket_ReadLength();
     std::vector<uint8_t> mimosa_data_0(datalength1);
     mimosa_data_0 = ni_control->DataTransportClientSocket_ReadData(datalength1);
@@ -87,13 +87,12 @@ bool NiRawEvent2StdEventConverter::Converting(eudaq::EventSPC d1, eudaq::Standar
       break;
     }
 
-    eudaq::StandardPlane plane(id, "NI", "MIMOSA26");
+    eudaq::StandardPlane &plane = d2->AddPlane(id, "NI", "MIMOSA26");
     plane.SetSizeZS(1152, 576, 0, 2, eudaq::StandardPlane::FLAG_WITHPIVOT |
 		    eudaq::StandardPlane::FLAG_DIFFCOORDS);
     plane.SetPivotPixel((9216 + pivot + PIVOTPIXELOFFSET) % 9216);
     DecodeFrame(plane, 0, &it0[8], len0);
     DecodeFrame(plane, 1, &it1[8], len1);
-    d2->AddPlane(plane);
 
     bool advance_one_block_0 = false;
     bool advance_one_block_1 = false;
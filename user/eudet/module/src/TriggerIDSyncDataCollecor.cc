@@ -84,7 +84,8 @@ namespace eudaq {
       }
     }
 
-    auto ev_sync = Event::MakeUnique("TriggerIDSyncOnline");
+    static constexpr uint32_t dspt_hash = cstr2hash("TriggerIDSyncOnline");
+    auto ev_sync = Event::MakeUnique("TriggerIDSyncOnline", dspt_hash);
     ev_sync->SetFlagPacket();
     ev_sync->SetTriggerN(trigger_n);
     for(auto &conn_evque: m_conn_evque){
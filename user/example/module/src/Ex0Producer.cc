@@ -1,4 +1,5 @@
 #include "eudaq/Producer.hh"
+#include "eudaq/EventPool.hh"
 #include <iostream>
 #include <fstream>
 #include <ratio>
@@ -105,8 +106,9 @@ void Ex0Producer::RunLoop(){
   std::mt19937 gen(rd());
   std::uniform_int_distribution<uint32_t> position(0, x_pixel*y_pixel-1);
   std::uniform_int_distribution<uint32_t> signal(0, 255);
+  eudaq::EventPool pool("Ex0Raw", 16, 1, x_pixel*y_pixel+2);
   while(!m_exit_of_run){
-    auto ev = eudaq::Event::MakeUnique("Ex0Raw");
+    auto ev = pool.MakeUnique();
     ev->SetTag("Plane ID", std::to_string(m_plane_id));
     auto tp_trigger = std::chrono::steady_clock::now();
     auto tp_end_of_busy = tp_trigger + m_ms_busy;
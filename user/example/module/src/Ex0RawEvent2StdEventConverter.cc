@@ -25,14 +25,13 @@ bool Ex0RawEvent2StdEventConverter::Converting(eudaq::EventSPC d1, eudaq::StdEve
     std::vector<uint8_t> hit(block.begin()+2, block.end());
     if(hit.size() != x_pixel*y_pixel)
       EUDAQ_THROW("Unknown data");
-    eudaq::StandardPlane plane(block_n, "my_ex0_plane", "my_ex0_plane");
+    eudaq::StandardPlane &plane = d2->AddPlane(block_n, "my_ex0_plane", "my_ex0_plane");
     plane.SetSizeZS(hit.size(), 1, 0);
     for(size_t i = 0; i < y_pixel; ++i) {
       for(size_t n = 0; n < x_pixel; ++n){
 	plane.PushPixel(n, i , hit[n+i*x_pixel]);
       }
     }
-    d2->AddPlane(plane);
   }
   return true;
 }
@@ -83,7 +83,8 @@ void Ex0TgDataCollector::DoReceive(eudaq::ConnectionSPC idx, eudaq::EventSP evsp
     }
   }
 
-  auto ev_sync = eudaq::Event::MakeUnique("Ex0Tg");
+  static constexpr uint32_t dspt_hash = eudaq::cstr2hash("Ex0Tg");
+  auto ev_sync = eudaq::Event::MakeUnique("Ex0Tg", dspt_hash);
   ev_sync->SetFlagPacket();
   ev_sync->SetTriggerN(trigger_n);
   for(auto &conn_evque: m_conn_evque){
@@ -1,5 +1,6 @@
 #include "eudaq/Producer.hh"
 #include "eudaq/Configuration.hh"
+#include "eudaq/EventPool.hh"
 
 #include <iostream>
 #include <ostream>
@@ -504,6 +505,7 @@ void Timepix3Producer::RunLoop() {
   std::cout << "Starting run loop..." << std::endl;
  
   unsigned int m_ev_next_update=0;
+  eudaq::EventPool pool("Timepix3RawDataEvent", 64, 1);
   // Create SpidrDaq for later (best place to do it?)
   spidrdaq = new SpidrDaq( spidrctrl );
 
@@ -672,7 +674,7 @@ void Timepix3Producer::RunLoop() {
 	  while( trigger_vec.size() > 1 ) {
 	    uint64_t start_time=GetTimeus();
 	    // Current event
-	    auto evup = eudaq::Event::MakeUnique("Timepix3RawDataEvent");
+	    auto evup = pool.MakeUnique();
 	    evup->SetTriggerN(m_ev);
 
 	    std::vector<unsigned char> bufferTrg;